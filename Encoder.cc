@@ -39,11 +39,15 @@ void Encoder::encodeAMO(Solver *S, vec<Lit> &lits) {
   lits.copyTo(lits_copy);
 
   switch (amo_encoding) {
-  // Currently only the ladder encoding is used for AMO constraints.
   case _AMO_LADDER_:
     ladder.encode(S, lits_copy);
     break;
 
+  // Propagated by the SAT solver itself, no clauses are added.
+  case _AMO_NATIVE_:
+    S->addAtMostOne(lits_copy);
+    break;
+
   default:
     printf("c Error: Invalid at-most-one encoding.\n");
     printf("s UNKNOWN\n");
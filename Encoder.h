@@ -36,6 +36,7 @@
 #endif
 
 #include "MaxTypes.h"
+#include "SATSolver.h"
 #include "core/SolverTypes.h"
 
 // Encodings
@@ -49,7 +50,7 @@
 
 using NSPACE::vec;
 using NSPACE::Lit;
-using NSPACE::Solver;
+using openwbo::Solver;
 
 namespace openwbo {
 
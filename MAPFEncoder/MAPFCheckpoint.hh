@@ -0,0 +1,585 @@
+#ifndef MAPFCheckpoint_hh
+#define MAPFCheckpoint_hh
+
+#include "MAPFtoMaxSAT.hh"
+#include <signal.h>
+#include <unistd.h>
+#include <inttypes.h>
+
+#define CHECKPOINT_MAGIC "MTMSCKPT"
+#define CHECKPOINT_VERSION 1
+
+//Checkpoints of the exact makespan and SoC search, a preempted run resumes
+//from the last one. A checkpoint holds the phase and bound of the search, the
+//slack and the plan that warm start the SoC phase and, while a bound is
+//searched, its formula, the best model with the bounds of the MaxSAT search
+//and optionally the learnt clauses and variable activities of its SAT solver.
+//It is written to a temporary file that replaces the previous checkpoint.
+struct MAPFCheckpoint : public CheckpointListener{
+  MAPFProblem *prob;
+  string file;
+  string key;
+  int interval;
+  unsigned int learntLBD;
+  void (*terminate)(int);
+
+  volatile sig_atomic_t requested;
+  volatile sig_atomic_t terminating;
+
+  int phase;
+  int bound;
+  MaxSAT *volatile mxsolver;
+  vector<unsigned char> formula;
+
+  bool resumed;
+  vector<unsigned char> resumedFormula;
+  vec<lbool> resumedModel;
+  uint64_t resumedLB;
+  uint64_t resumedUB;
+  vec<Lit> resumedClauses;
+  vec<double> resumedActivities;
+
+  //key identifies the instance and the options the formulas depend on, a
+  //checkpoint with another key is not resumed. The learnt clauses with an LBD
+  //up to lbd are saved, none and no activities with 0.
+  MAPFCheckpoint(MAPFProblem &p, string f, string k, int ival, int lbd){
+    prob = &p;
+    file = f;
+    key = k;
+    interval = ival;
+    learntLBD = lbd;
+    terminate = NULL;
+    requested = 0;
+    terminating = 0;
+    phase = 1;
+    bound = 0;
+    mxsolver = NULL;
+    resumed = false;
+    resumedLB = 0;
+    resumedUB = 0;
+  }
+
+  //asks for a checkpoint as soon as the search allows it, the run is then
+  //terminated if term is set. Safe to use from a signal handler.
+  void request(bool term){
+    if(term) terminating = 1;
+    requested = 1;
+    MaxSAT *S = mxsolver;
+    if(S!=NULL) S->interruptSearch();
+  }
+
+  bool inSearch(){ return mxsolver!=NULL; }
+
+  bool checkpointRequested(){ return requested; }
+
+  //the formula is saved as it is loaded, the algorithms extend it later on
+  void startSearch(MaxSAT *S, MaxSATFormula *f, int b){
+    formula.clear();
+    putFormula(formula,f);
+    bound = b;
+    mxsolver = S;
+  }
+
+  void endSearch(){
+    mxsolver = NULL;
+    formula.clear();
+    resumedModel.clear();
+    resumedClauses.clear();
+    resumedActivities.clear();
+  }
+
+  void saveCheckpoint(MaxSAT *mx, Solver *S){
+    write(mx,S);
+  }
+
+  //checkpoint between two searches, e.g. once a bound is proven infeasible
+  void save(int ph, int b){
+    phase = ph;
+    bound = b;
+    write(NULL,NULL);
+  }
+
+  //saves the bound about to be searched, unless it is the one resumed
+  void startBound(int ph, int b){
+    if(resumed and ph==phase and b==bound){
+      resumed = false;
+      return;
+    }
+    resumed = false;
+    resumedFormula.clear();
+    save(ph,b);
+  }
+
+  //the run is over, a checkpoint would only restart it
+  void finish(){
+    remove(file.c_str());
+  }
+
+  //the clauses kept from the previous run hold in every solver of the search
+  //of the same bound, they are implied by the hard clauses
+  void restoreSolver(Solver *S){
+    for(int i=0;i<resumedActivities.size() and i<S->nVars();++i){
+      S->setActivity(i,resumedActivities[i]);
+    }
+    vec<Lit> lits;
+    for(int i=0;i<resumedClauses.size();++i){
+      if(resumedClauses[i]!=lit_Undef){
+	lits.push(resumedClauses[i]);
+	continue;
+      }
+      bool known = true;
+      for(int j=0;j<lits.size() and known;++j) known = var(lits[j])<S->nVars();
+      if(known) S->addClause(lits);
+      lits.clear();
+    }
+  }
+
+  //formula of the search of bound b saved by the checkpoint the run resumed
+  //from, NULL if there is none. The variables of the encoder are created as
+  //encodeForOpenWBO does to decode the models.
+  MaxSATFormula *restoreFormula(MAPFEncoder &e, int b, int encoding){
+    if(resumedFormula.empty() or b!=bound) return NULL;
+    Reader r(resumedFormula);
+    MaxSATFormula *f = getFormula(r);
+    resumedFormula.clear();
+    if(not r.ok){
+      delete(f);
+      printf("c Checkpoint formula is corrupted, encoding it again\n");
+      return NULL;
+    }
+    e.unsatDetected = false;
+    e.cellShifts = (encoding!=3);
+    e.createVars(*prob,b);
+    return f;
+  }
+
+  //warm starts the search with the best model of the previous run: its
+  //positions are the initial partial model and it is the incumbent the SAT
+  //solvers start from
+  void restoreSearch(MAPFEncoder &e, MaxSAT *S){
+    if(resumedModel.size()==0) return;
+    vec<Lit> partialModel;
+    for(int v=0;v<e.lastOnVar and v<resumedModel.size();++v){
+      if(resumedModel[v]==l_True) partialModel.push(mkLit(v));
+    }
+    S->loadInitialPartialModel(partialModel);
+    resumedModel.copyTo(S->getModel());
+    printf("c Resumed search with UB:%16" PRIu64 "\n",resumedUB);
+    printf("c Resumed search with LB:%16" PRIu64 "\n",resumedLB);
+  }
+
+  //reads the checkpoint, returns false if there is none for this run
+  bool resume(){
+    FILE *in = fopen(file.c_str(),"rb");
+    if(in==NULL){
+      printf("c No checkpoint in %s, starting from scratch\n",file.c_str());
+      return false;
+    }
+    vector<unsigned char> data;
+    unsigned char buffer[1<<16];
+    size_t n;
+    while((n = fread(buffer,1,sizeof(buffer),in))>0) data.insert(data.end(),buffer,buffer+n);
+    fclose(in);
+
+    Reader r(data);
+    string magic = r.getString();
+    int version = r.getVarint();
+    if(not r.ok or magic!=CHECKPOINT_MAGIC or version!=CHECKPOINT_VERSION){
+      printf("c %s is not a checkpoint, starting from scratch\n",file.c_str());
+      return false;
+    }
+    if(r.getString()!=key){
+      printf("c Checkpoint %s is for another instance or encoding, starting from scratch\n",file.c_str());
+      return false;
+    }
+    int ph = r.getVarint();
+    int b = r.getVarint();
+    int slack = r.getInt();
+    vector<Assignment> plan;
+    int planSize = r.getVarint();
+    for(int i=0;i<planSize and r.ok;++i){
+      int type = r.getVarint();
+      int x = r.getVarint();
+      int y = r.getVarint();
+      int a = r.getVarint();
+      int t = r.getVarint();
+      int op = r.getInt();
+      plan.push_back(Assignment(type,x,y,a,t,op));
+    }
+    vector<unsigned char> f;
+    vec<lbool> model;
+    uint64_t lb = 0, ub = 0;
+    vec<Lit> clauses;
+    vec<double> activities;
+    if(r.getVarint()){
+      r.getBytes(f);
+      r.getBits(model,r.getVarint());
+      lb = r.getVarint();
+      ub = r.getVarint();
+      int na = r.getVarint();
+      for(int v=0;v<na and r.ok;++v) activities.push(r.getFloat());
+      r.getClauses(clauses);
+    }
+    if(not r.ok){
+      printf("c Checkpoint %s is corrupted, starting from scratch\n",file.c_str());
+      return false;
+    }
+
+    phase = ph;
+    bound = b;
+    prob->socSlack = slack;
+    prob->solution = plan;
+    resumedFormula.swap(f);
+    model.moveTo(resumedModel);
+    resumedLB = lb;
+    resumedUB = ub;
+    clauses.moveTo(resumedClauses);
+    activities.moveTo(resumedActivities);
+    resumed = true;
+    printf("c Resumed from checkpoint %s: phase %d, bound %d\n",file.c_str(),phase,bound);
+    return true;
+  }
+
+  //the learnt clauses of the solver are only saved before the first model:
+  //they are implied by the hard clauses then, the later ones may depend on
+  //the upper bound
+  void write(MaxSAT *mx, Solver *S){
+    requested = 0;
+    double startTime = NSPACE::realTime();
+    vector<unsigned char> out;
+    putString(out,CHECKPOINT_MAGIC);
+    putVarint(out,CHECKPOINT_VERSION);
+    putString(out,key);
+    putVarint(out,phase);
+    putVarint(out,bound);
+    putInt(out,prob->socSlack);
+    putVarint(out,prob->solution.size());
+    for(Assignment &s:prob->solution){
+      putVarint(out,s.type);
+      putVarint(out,s.xPos);
+      putVarint(out,s.yPos);
+      putVarint(out,s.agent);
+      putVarint(out,s.t);
+      putInt(out,s.op);
+    }
+    putVarint(out,mx!=NULL);
+    if(mx!=NULL){
+      putBytes(out,formula);
+      vec<lbool> &model = mx->getModel();
+      putVarint(out,model.size());
+      putBits(out,model);
+      putVarint(out,model.size()>0 ? mx->getLowerBound() : 0);
+      putVarint(out,model.size()>0 ? mx->getUpperBound() : 0);
+      int nv = mx->getMaxSATFormula()->nInitialVars();
+      vec<Lit> learnts;
+      if(S!=NULL and learntLBD>0){
+	putVarint(out,min(nv,S->nVars()));
+	double top = 0;
+	for(int v=0;v<nv and v<S->nVars();++v) top = max(top,S->getActivity(v));
+	for(int v=0;v<nv and v<S->nVars();++v) putFloat(out,top>0 ? S->getActivity(v)/top : 0);
+	if(model.size()==0) S->exportLearnts(learnts,nv,learntLBD);
+      }else{
+	putVarint(out,0);
+      }
+      putClauses(out,learnts);
+    }
+
+    string tmp = file+string(".tmp");
+    FILE *o = fopen(tmp.c_str(),"wb");
+    bool written = o!=NULL and fwrite(out.data(),1,out.size(),o)==out.size();
+    if(o!=NULL){
+      written = fflush(o)==0 and fsync(fileno(o))==0 and written;
+      written = fclose(o)==0 and written;
+    }
+    if(written and rename(tmp.c_str(),file.c_str())==0){
+      printf("c Checkpoint saved in %s: phase %d, bound %d, %zu bytes in %.2fs\n",file.c_str(),phase,bound,out.size(),NSPACE::realTime()-startTime);
+    }else{
+      printf("c WARNING! Could not save the checkpoint in %s\n",file.c_str());
+    }
+    fflush(stdout);
+    if(interval>0) alarm(interval);
+    if(terminating and terminate!=NULL) terminate(SIGTERM);
+  }
+
+  //compact binary format: integers are written with 7 bits per byte, signed
+  //ones zigzag encoded, and the literals of a clause as the difference with
+  //the previous one, close literals take a single byte
+  static void putVarint(vector<unsigned char> &out, uint64_t x){
+    while(x>=0x80){
+      out.push_back((x & 0x7f) | 0x80);
+      x >>= 7;
+    }
+    out.push_back(x);
+  }
+
+  static void putInt(vector<unsigned char> &out, int64_t x){
+    putVarint(out,((uint64_t)x << 1) ^ (uint64_t)(x >> 63));
+  }
+
+  static void putString(vector<unsigned char> &out, string s){
+    putVarint(out,s.size());
+    out.insert(out.end(),s.begin(),s.end());
+  }
+
+  static void putBytes(vector<unsigned char> &out, vector<unsigned char> &bytes){
+    putVarint(out,bytes.size());
+    out.insert(out.end(),bytes.begin(),bytes.end());
+  }
+
+  static void putDouble(vector<unsigned char> &out, double d){
+    unsigned char b[sizeof(double)];
+    memcpy(b,&d,sizeof(double));
+    out.insert(out.end(),b,b+sizeof(double));
+  }
+
+  static void putFloat(vector<unsigned char> &out, float f){
+    unsigned char b[sizeof(float)];
+    memcpy(b,&f,sizeof(float));
+    out.insert(out.end(),b,b+sizeof(float));
+  }
+
+  static void putBits(vector<unsigned char> &out, vec<lbool> &model){
+    for(int v=0;v<model.size();v+=8){
+      unsigned char byte = 0;
+      for(int i=0;i<8 and v+i<model.size();++i){
+	if(model[v+i]==l_True) byte |= 1<<i;
+      }
+      out.push_back(byte);
+    }
+  }
+
+  static void putLits(vector<unsigned char> &out, vec<Lit> &lits){
+    putVarint(out,lits.size());
+    int previous = 0;
+    for(int i=0;i<lits.size();++i){
+      putInt(out,toInt(lits[i])-previous);
+      previous = toInt(lits[i]);
+    }
+  }
+
+  //clauses closed by lit_Undef
+  static void putClauses(vector<unsigned char> &out, vec<Lit> &clauses){
+    int n = 0;
+    for(int i=0;i<clauses.size();++i) n += clauses[i]==lit_Undef;
+    putVarint(out,n);
+    vec<Lit> lits;
+    for(int i=0;i<clauses.size();++i){
+      if(clauses[i]!=lit_Undef){
+	lits.push(clauses[i]);
+      }else{
+	putLits(out,lits);
+	lits.clear();
+      }
+    }
+  }
+
+  static void putVars(vector<unsigned char> &out, vec<int> &vars){
+    putVarint(out,vars.size());
+    int previous = 0;
+    for(int i=0;i<vars.size();++i){
+      putInt(out,vars[i]-previous);
+      previous = vars[i];
+    }
+  }
+
+  //everything copyMaxSATFormula copies
+  static void putFormula(vector<unsigned char> &out, MaxSATFormula *f){
+    putVarint(out,f->nVars());
+    putVarint(out,f->getProblemType());
+    putVarint(out,f->getHardWeight());
+    putVarint(out,f->getSumWeights());
+    putVarint(out,f->getMaximumWeight());
+    putVarint(out,f->nSoft());
+    for(int i=0;i<f->nSoft();++i){
+      putVarint(out,f->getSoftClause(i).weight);
+      putLits(out,f->getSoftClause(i).clause);
+    }
+    putVarint(out,f->nHard());
+    for(int i=0;i<f->nHard();++i){
+      putLits(out,f->getHardClause(i).clause);
+    }
+    putVarint(out,f->nCard());
+    for(int i=0;i<f->nCard();++i){
+      putInt(out,f->getCardinalityConstraint(i)->_rhs);
+      putLits(out,f->getCardinalityConstraint(i)->_lits);
+    }
+    putVarint(out,f->getAMOEncoding());
+    putVars(out,f->getFrozenVars());
+    putVars(out,f->getHintVars());
+    for(int i=0;i<f->getHintVars().size();++i){
+      putDouble(out,f->getHintActivities()[i]);
+      putVarint(out,toInt(f->getHintPhases()[i]));
+    }
+    putVars(out,f->getNonDecisionVars());
+    putVarint(out,f->nSoftGroups()>0);
+    if(f->nSoftGroups()>0){
+      for(int i=0;i<f->nSoft();++i) putInt(out,f->getSoftGroup(i));
+    }
+    putVarint(out,f->nSoftGroupEdges());
+    for(int i=0;i<f->nSoftGroupEdges();++i){
+      putVarint(out,f->getSoftGroupEdgeFrom(i));
+      putVarint(out,f->getSoftGroupEdgeTo(i));
+      putDouble(out,f->getSoftGroupEdgeWeight(i));
+    }
+  }
+
+  //reads what the put functions write, ok is cleared at the first read past
+  //the end of the data
+  struct Reader{
+    vector<unsigned char> &data;
+    size_t pos;
+    int bit;
+    bool ok;
+
+    Reader(vector<unsigned char> &d) : data(d), pos(0), bit(0), ok(true) {}
+
+    uint64_t getVarint(){
+      uint64_t x = 0;
+      for(int shift=0;ok;shift+=7){
+	if(pos>=data.size() or shift>63){
+	  ok = false;
+	  break;
+	}
+	unsigned char b = data[pos++];
+	x |= (uint64_t)(b & 0x7f) << shift;
+	if(not (b & 0x80)) break;
+      }
+      return x;
+    }
+
+    int64_t getInt(){
+      uint64_t x = getVarint();
+      return (int64_t)(x >> 1) ^ -(int64_t)(x & 1);
+    }
+
+    bool has(size_t n){
+      if(pos+n>data.size()) ok = false;
+      return ok;
+    }
+
+    string getString(){
+      size_t n = getVarint();
+      if(not has(n)) return string();
+      string s(data.begin()+pos,data.begin()+pos+n);
+      pos += n;
+      return s;
+    }
+
+    void getBytes(vector<unsigned char> &bytes){
+      size_t n = getVarint();
+      if(not has(n)) return;
+      bytes.assign(data.begin()+pos,data.begin()+pos+n);
+      pos += n;
+    }
+
+    double getDouble(){
+      double d = 0;
+      if(not has(sizeof(double))) return d;
+      memcpy(&d,&data[pos],sizeof(double));
+      pos += sizeof(double);
+      return d;
+    }
+
+    float getFloat(){
+      float f = 0;
+      if(not has(sizeof(float))) return f;
+      memcpy(&f,&data[pos],sizeof(float));
+      pos += sizeof(float);
+      return f;
+    }
+
+    void getBits(vec<lbool> &model, int n){
+      size_t bytes = (n+7)/8;
+      if(not has(bytes)) return;
+      for(int v=0;v<n;++v){
+	model.push(data[pos+v/8] & (1<<(v%8)) ? l_True : l_False);
+      }
+      pos += bytes;
+    }
+
+    void getLits(vec<Lit> &lits){
+      int n = getVarint();
+      int previous = 0;
+      for(int i=0;i<n and ok;++i){
+	previous += getInt();
+	lits.push(NSPACE::toLit(previous));
+      }
+    }
+
+    void getClauses(vec<Lit> &clauses){
+      int n = getVarint();
+      for(int i=0;i<n and ok;++i){
+	getLits(clauses);
+	clauses.push(lit_Undef);
+      }
+    }
+
+    void getVars(vec<int> &vars){
+      int n = getVarint();
+      int previous = 0;
+      for(int i=0;i<n and ok;++i){
+	previous += getInt();
+	vars.push(previous);
+      }
+    }
+  };
+
+  static MaxSATFormula *getFormula(Reader &r){
+    MaxSATFormula *f = new MaxSATFormula();
+    int nv = r.getVarint();
+    for(int v=0;v<nv;++v) f->newVar();
+    f->setProblemType(r.getVarint());
+    f->setHardWeight(r.getVarint());
+    f->updateSumWeights(r.getVarint());
+    f->setMaximumWeight(r.getVarint());
+    int nSoft = r.getVarint();
+    for(int i=0;i<nSoft and r.ok;++i){
+      uint64_t weight = r.getVarint();
+      vec<Lit> lits;
+      r.getLits(lits);
+      f->addSoftClause(weight,lits);
+    }
+    int nHard = r.getVarint();
+    for(int i=0;i<nHard and r.ok;++i){
+      vec<Lit> lits;
+      r.getLits(lits);
+      f->addHardClause(lits);
+    }
+    int nCard = r.getVarint();
+    for(int i=0;i<nCard and r.ok;++i){
+      int64_t rhs = r.getInt();
+      vec<Lit> lits;
+      r.getLits(lits);
+      f->addCardinalityConstraint(new Card(lits,rhs));
+    }
+    f->setAMOEncoding(r.getVarint());
+    vec<int> vars;
+    r.getVars(vars);
+    for(int i=0;i<vars.size();++i) f->addFrozenVar(vars[i]);
+    vars.clear();
+    r.getVars(vars);
+    for(int i=0;i<vars.size() and r.ok;++i){
+      double activity = r.getDouble();
+      lbool phase = NSPACE::toLbool(r.getVarint());
+      f->addDecisionHint(vars[i],activity,phase);
+    }
+    vars.clear();
+    r.getVars(vars);
+    for(int i=0;i<vars.size();++i) f->addNonDecisionVar(vars[i]);
+    if(r.getVarint()){
+      for(int i=0;i<nSoft and r.ok;++i){
+	int group = r.getInt();
+	if(group!=-1) f->setSoftGroup(i,group);
+      }
+    }
+    int nEdges = r.getVarint();
+    for(int i=0;i<nEdges and r.ok;++i){
+      int from = r.getVarint();
+      int to = r.getVarint();
+      f->addSoftGroupEdge(from,to,r.getDouble());
+    }
+    return f;
+  }
+};
+
+#endif
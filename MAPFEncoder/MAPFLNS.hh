@@ -0,0 +1,392 @@
+#ifndef MAPFLNS_hh
+#define MAPFLNS_hh
+
+#include "MAPFtoMaxSAT.hh"
+#include "utils/System.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <random>
+#include <algorithm>
+
+#define LNS_RANDOM 0
+#define LNS_CONFLICT 1
+#define LNS_SPATIAL 2
+#define LNS_MIXED 3
+
+//Stops the search of the makespan optimal bound at its first plan, that LNS
+//improves instead of the exact SoC optimization of the bound.
+struct MAPFFirstPlan : public UBListener{
+  MaxSAT *solver;
+
+  MAPFFirstPlan(MaxSAT *s){
+    solver = s;
+  }
+
+  void upperBoundImproved(uint64_t cost, vec<Lit> &units){
+    solver->stopSearch();
+  }
+};
+
+//Anytime Large Neighborhood Search: starting from a feasible plan, repeatedly
+//frees a small set of agents, fixes the paths of all the others and re-solves
+//the subproblem to SoC optimality with the MaxSAT encoding. Only the free
+//agents are encoded, every thread reuses its subproblem and encoder. The search of a
+//neighborhood is stopped at its time budget or at the time limit of LNS, and
+//its best model is used.
+struct MAPFLNS{
+  MAPFProblem *prob;
+  MaxSATFactory factory;
+  int bound;
+  int encoding;
+  int amoEncoding;
+  int problemFormulation;
+  int algorithm;
+  int cardinality;
+  int neighborhoodType;
+  int neighborhoodSize;
+  int nThreads;
+  double timeLimit;
+  //wall clock budget of the search of one neighborhood
+  double neighborhoodTime;
+  string outputFile;
+
+  mutex lock;
+  //signals the monitor that a search started or a worker finished
+  condition_variable changed;
+  //search of every worker and the time at which it is stopped
+  vector<MaxSAT*> running;
+  vector<double> deadlines;
+  int activeWorkers;
+  vector< Path > bestPaths;
+  int bestCost;
+  int version;
+  int iterations;
+  int failures;
+  int stoppedSearches;
+  double startTime;
+  vector< pair<double,int> > trajectory;
+
+  MAPFLNS(MAPFProblem &p, MaxSATFactory f, int bnd, int enc, int amoEnc, int formulation, int alg, int card){
+    prob = &p;
+    factory = f;
+    bound = bnd;
+    encoding = enc;
+    amoEncoding = amoEnc;
+    problemFormulation = formulation;
+    algorithm = alg;
+    cardinality = card;
+    neighborhoodType = LNS_MIXED;
+    neighborhoodSize = 8;
+    nThreads = 1;
+    timeLimit = 60;
+    neighborhoodTime = 2;
+    bestCost = INT_MAX;
+    version = 0;
+    iterations = 0;
+    failures = 0;
+    stoppedSearches = 0;
+    activeWorkers = 0;
+  }
+
+  int planCost(vector< Path > &paths){
+    int cost = 0;
+    for(int a=0;a<prob->nAgents;++a){
+      cost += prob->getArrivalTime(a,paths[a]);
+    }
+    return cost;
+  }
+
+  //mirrors the conflicts forbidden by encodeHard: two agents never share a
+  //cell, and an agent may only enter an occupied cell if the occupant swaps
+  //with it (problemFormulation 0) or never (problemFormulation 1)
+  bool isValid(vector< Path > &paths){
+    vector<int> occupant(prob->gridX*prob->gridY,-1);
+    for(int t=0;t<=bound;++t){
+      for(int a=0;a<prob->nAgents;++a){
+	int c = paths[a][t].first*prob->gridY+paths[a][t].second;
+	if(occupant[c]!=-1) return false;
+	occupant[c] = a;
+      }
+      if(t<bound){
+	for(int a=0;a<prob->nAgents;++a){
+	  if(paths[a][t+1]==paths[a][t]) continue;
+	  int b = occupant[paths[a][t+1].first*prob->gridY+paths[a][t+1].second];
+	  if(b==-1) continue;
+	  if(problemFormulation==1 or paths[b][t+1]!=paths[a][t]) return false;
+	}
+      }
+      for(int a=0;a<prob->nAgents;++a){
+	occupant[paths[a][t].first*prob->gridY+paths[a][t].second] = -1;
+      }
+    }
+    return true;
+  }
+
+  bool isDelayed(int a, vector< Path > &paths){
+    return prob->getArrivalTime(a,paths[a]) > prob->getShortestPathLength(a);
+  }
+
+  int randomDelayedAgent(vector< Path > &paths, mt19937 &rng){
+    vector<int> delayed;
+    for(int a=0;a<prob->nAgents;++a){
+      if(isDelayed(a,paths)) delayed.push_back(a);
+    }
+    if(delayed.empty()) return rng()%prob->nAgents;
+    return delayed[rng()%delayed.size()];
+  }
+
+  void randomNeighborhood(vector< Path > &paths, mt19937 &rng, vector<int> &agents){
+    vector<int> all(prob->nAgents);
+    for(int a=0;a<prob->nAgents;++a) all[a] = a;
+    shuffle(all.begin(),all.end(),rng);
+    agents.assign(all.begin(),all.begin()+min(neighborhoodSize,prob->nAgents));
+  }
+
+  //a delayed agent plus the agents whose paths occupy its shortest path
+  //corridor, and transitively the agents crossing their paths
+  void conflictNeighborhood(vector< Path > &paths, mt19937 &rng, vector<int> &agents){
+    int seed = randomDelayedAgent(paths,rng);
+    int sp = prob->getShortestPathLength(seed);
+    vector<bool> selected(prob->nAgents,false);
+    vector< vector<int> > visitors(prob->gridX*prob->gridY);
+    for(int a=0;a<prob->nAgents;++a){
+      for(int t=0;t<=bound;++t){
+	int c = paths[a][t].first*prob->gridY+paths[a][t].second;
+	if(visitors[c].empty() or visitors[c].back()!=a) visitors[c].push_back(a);
+      }
+    }
+    agents.clear();
+    agents.push_back(seed);
+    selected[seed] = true;
+    vector<int> frontier;
+    for(int x=0;x<prob->gridX;++x){
+      for(int y=0;y<prob->gridY;++y){
+	if(not prob->obstacle(x,y) and
+	   prob->grid[x][y].distanceToStarts[seed]!=INFINITE and
+	   prob->grid[x][y].distanceToStarts[seed]+prob->grid[x][y].distanceToGoals[seed]==sp){
+	  for(int b:visitors[x*prob->gridY+y]) frontier.push_back(b);
+	}
+      }
+    }
+    size_t next = 0;
+    while(agents.size()<(size_t)neighborhoodSize){
+      if(frontier.empty()){
+	if(next>=agents.size()) break;
+	for(pair<int,int> c:paths[agents[next++]]){
+	  for(int b:visitors[c.first*prob->gridY+c.second]) frontier.push_back(b);
+	}
+	continue;
+      }
+      shuffle(frontier.begin(),frontier.end(),rng);
+      for(int b:frontier){
+	if(agents.size()<(size_t)neighborhoodSize and not selected[b]){
+	  selected[b] = true;
+	  agents.push_back(b);
+	}
+      }
+      frontier.clear();
+    }
+  }
+
+  //agents passing through a square window around a random position of a
+  //delayed agent
+  void spatialNeighborhood(vector< Path > &paths, mt19937 &rng, vector<int> &agents){
+    int seed = randomDelayedAgent(paths,rng);
+    pair<int,int> center = paths[seed][rng()%(bound+1)];
+    int radius = 1;
+    agents.clear();
+    while(agents.size()<(size_t)neighborhoodSize and radius<=max(prob->gridX,prob->gridY)){
+      agents.clear();
+      for(int a=0;a<prob->nAgents;++a){
+	for(int t=0;t<=bound;++t){
+	  if(abs(paths[a][t].first-center.first)<=radius and abs(paths[a][t].second-center.second)<=radius){
+	    agents.push_back(a);
+	    break;
+	  }
+	}
+      }
+      radius++;
+    }
+    shuffle(agents.begin(),agents.end(),rng);
+    if(agents.size()>(size_t)neighborhoodSize) agents.resize(neighborhoodSize);
+  }
+
+  void selectNeighborhood(int type, vector< Path > &paths, mt19937 &rng, vector<int> &agents){
+    switch(type){
+    case LNS_RANDOM:   randomNeighborhood(paths,rng,agents);break;
+    case LNS_CONFLICT: conflictNeighborhood(paths,rng,agents);break;
+    case LNS_SPATIAL:  spatialNeighborhood(paths,rng,agents);break;
+    }
+  }
+
+  //re-plans the agents in the neighborhood keeping all the others fixed,
+  //returns true if a plan for the subproblem was found, even if its search
+  //was stopped before proving it optimal
+  bool solveNeighborhood(int id, MAPFProblem &sub, MAPFEncoder &e, vector< Path > &base, vector<int> &agents, vector< Path > &result){
+    sub.setSubproblem(*prob,agents,base,bound);
+    //a better plan does not delay the neighborhood more than the current one
+    sub.socSlack = 0;
+    for(size_t i=0;i<agents.size();++i){
+      int a = agents[i];
+      sub.socSlack += prob->getArrivalTime(a,base[a])-prob->getShortestPathLength(a);
+      for(int t=0;t<=bound;++t){
+	sub.solution.push_back(Assignment(0,base[a][t].first,base[a][t].second,i,t,-1));
+      }
+    }
+    MaxSATFormula *f = e.encodeForOpenWBO(sub,bound,encoding,amoEncoding,problemFormulation);
+    bool solved = false;
+    if(not e.unsatDetected){
+      MaxSAT *S = factory(algorithm,cardinality,0,_VERBOSITY_MINIMAL_);
+      S->setPrint(false);
+      S->setInitialTime(NSPACE::realTime());
+      S->loadFormula(f);
+      vec<Lit> partialModel;
+      e.getModelFromSolution(sub.solution,partialModel);
+      S->loadInitialPartialModel(partialModel);
+      {
+	lock_guard<mutex> guard(lock);
+	running[id] = S;
+	deadlines[id] = min(NSPACE::realTime()+neighborhoodTime,startTime+timeLimit);
+      }
+      changed.notify_one();
+      StatusCode ret = S->search();
+      {
+	lock_guard<mutex> guard(lock);
+	running[id] = NULL;
+	if(ret!=_OPTIMUM_) stoppedSearches++;
+      }
+      if(ret==_OPTIMUM_ or ret==_SATISFIABLE_){
+	vector< Path > paths;
+	e.decodePathsFromOpenWBO(sub,bound,S,paths);
+	result = base;
+	for(size_t i=0;i<agents.size();++i) result[agents[i]] = paths[i];
+	solved = true;
+      }
+      delete(S);
+    }else{
+      delete(f);
+    }
+    return solved;
+  }
+
+  void improve(vector< Path > &paths, int cost){
+    bestPaths = paths;
+    bestCost = cost;
+    version++;
+    double elapsed = NSPACE::realTime()-startTime;
+    trajectory.push_back(make_pair(elapsed,cost));
+    printf("c LNS time[s]: %10.2f soc: %10d\n",elapsed,cost);
+    fflush(stdout);
+    writePlan();
+  }
+
+  void worker(int id, MAPFProblem &sub, MAPFEncoder &e){
+    mt19937 rng(id+1);
+    int round = 0;
+    while(NSPACE::realTime()-startTime < timeLimit){
+      vector< Path > base;
+      int baseVersion;
+      {
+	lock_guard<mutex> guard(lock);
+	if(bestCost==prob->bestPossibleCost) return;
+	base = bestPaths;
+	baseVersion = version;
+      }
+      int type = neighborhoodType==LNS_MIXED ? (id+round++)%3 : neighborhoodType;
+      vector<int> agents;
+      selectNeighborhood(type,base,rng,agents);
+      vector< Path > result;
+      bool solved = solveNeighborhood(id,sub,e,base,agents,result);
+      lock_guard<mutex> guard(lock);
+      iterations++;
+      if(not solved){
+	failures++;
+	continue;
+      }
+      //other threads may have changed the agents this subproblem kept fixed
+      vector< Path > candidate = baseVersion==version ? result : bestPaths;
+      if(baseVersion!=version){
+	for(int a:agents) candidate[a] = result[a];
+      }
+      int cost = planCost(candidate);
+      if(cost<bestCost and isValid(candidate)){
+	improve(candidate,cost);
+      }
+    }
+  }
+
+  void workerThread(int id){
+    MAPFProblem sub(prob);
+    MAPFEncoder e;
+    e.verbosity = 0;
+    worker(id,sub,e);
+    e.clean();
+    lock_guard<mutex> guard(lock);
+    activeWorkers--;
+    changed.notify_one();
+  }
+
+  //stops the search of every neighborhood at its deadline
+  void monitor(){
+    unique_lock<mutex> guard(lock);
+    while(activeWorkers>0){
+      double now = NSPACE::realTime();
+      double next = -1;
+      for(int i=0;i<nThreads;++i){
+	if(running[i]==NULL) continue;
+	if(deadlines[i]<=now){
+	  running[i]->stopSearch();
+	  running[i] = NULL;
+	}else if(next<0 or deadlines[i]<next){
+	  next = deadlines[i];
+	}
+      }
+      if(next<0) changed.wait(guard);
+      else changed.wait_for(guard,chrono::duration<double>(next-now));
+    }
+  }
+
+  void writePlan(){
+    FILE *o = fopen(outputFile.c_str(),"wt");
+    for(int a=0;a<prob->nAgents;++a){
+      for(int t=0;t<=bound;++t){
+	fprintf(o,"on(%d,%d,%d,%d)\n",a,bestPaths[a][t].first,bestPaths[a][t].second,t);
+      }
+    }
+    fclose(o);
+  }
+
+  //improves the plan stored in p.solution, returns the SoC of the best plan found
+  int run(string outputPrefix){
+    outputFile = outputPrefix+string("_lns.sol");
+    startTime = NSPACE::realTime();
+    vector< Path > initial;
+    prob->getPathsFromSolution(bound,initial);
+    if(not isValid(initial)){
+      printf("c LNS: initial plan is not valid\n");
+      return INT_MAX;
+    }
+    improve(initial,planCost(initial));
+    running.assign(nThreads,NULL);
+    deadlines.assign(nThreads,0);
+    activeWorkers = nThreads;
+    vector<thread> threads;
+    for(int i=0;i<nThreads;++i){
+      threads.push_back(thread(&MAPFLNS::workerThread,this,i));
+    }
+    monitor();
+    for(int i=0;i<nThreads;++i){
+      threads[i].join();
+    }
+    printf("c LNS iterations: %d (%d failed, %d stopped) with %d threads\n",iterations,failures,stoppedSearches,nThreads);
+    printf("c LNS trajectory:\n");
+    for(size_t i=0;i<trajectory.size();++i){
+      printf("c   %10.2f %10d\n",trajectory[i].first,trajectory[i].second);
+    }
+    return bestCost;
+  }
+};
+
+#endif
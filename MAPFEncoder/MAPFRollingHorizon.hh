@@ -0,0 +1,161 @@
+#ifndef MAPFRollingHorizon_hh
+#define MAPFRollingHorizon_hh
+
+#include "MAPFtoMaxSAT.hh"
+#include "utils/System.h"
+
+//Rolling horizon planning: only the first window time steps are solved with
+//collisions, the rest of the motion is summarized by the distance to the goal
+//at the end of the window. The first commit steps of the plan are executed,
+//the agents are moved and the window slides forward. When a committed prefix
+//does not bring the agents closer to their goals (e.g. an agent has to leave
+//a corridor to let another one in) the window is doubled until it does.
+struct MAPFRollingHorizon{
+  MAPFProblem *prob;
+  MaxSATFactory factory;
+  int window;
+  int maxWindow;
+  int commit;
+  int maxSteps;
+  int encoding;
+  int amoEncoding;
+  int problemFormulation;
+  int algorithm;
+  int cardinality;
+
+  MAPFRollingHorizon(MAPFProblem &p, MaxSATFactory f, int w, int c, int enc, int amoEnc, int formulation, int alg, int card){
+    prob = &p;
+    factory = f;
+    window = w;
+    maxWindow = 16*w;
+    commit = c>0 ? min(c,w) : max(1,w/2);
+    maxSteps = 0;
+    encoding = enc;
+    amoEncoding = amoEnc;
+    problemFormulation = formulation;
+    algorithm = alg;
+    cardinality = card;
+  }
+
+  bool atGoal(int a, pair<int,int> pos){
+    return pos.first==prob->getGoalX(a) and pos.second==prob->getGoalY(a);
+  }
+
+  //solves the current window warm started with the assignments in
+  //prob->solution, returns false if no plan exists for it
+  bool solveWindow(MAPFEncoder &e, int w, vector< Path > &paths){
+    MaxSATFormula *f = e.encodeForOpenWBO(*prob,w,encoding,amoEncoding,problemFormulation);
+    if(e.unsatDetected){
+      delete(f);
+      return false;
+    }
+    MaxSAT *S = factory(algorithm,cardinality,0,_VERBOSITY_MINIMAL_);
+    S->setPrint(false);
+    S->setInitialTime(NSPACE::realTime());
+    S->loadFormula(f);
+    vec<Lit> partialModel;
+    e.getModelFromSolution(prob->solution,partialModel);
+    S->loadInitialPartialModel(partialModel);
+    int ret = S->search();
+    bool solved = (ret==_OPTIMUM_ or ret==_SATISFIABLE_);
+    if(solved) e.decodePathsFromOpenWBO(*prob,w,S,paths);
+    delete(S);
+    return solved;
+  }
+
+  int distanceToGoals(vector< pair<int,int> > &positions){
+    int d = 0;
+    for(int a=0;a<prob->nAgents;++a){
+      d += prob->grid[positions[a].first][positions[a].second].distanceToGoals[a];
+    }
+    return d;
+  }
+
+  void writePlan(vector< Path > &executed, string outputFile){
+    FILE *o = fopen(outputFile.c_str(),"wt");
+    for(int a=0;a<prob->nAgents;++a){
+      for(int t=0;t<(int)executed[a].size();++t){
+	fprintf(o,"on(%d,%d,%d,%d)\n",a,executed[a][t].first,executed[a][t].second,t);
+      }
+    }
+    fclose(o);
+  }
+
+  //plans until every agent is at its goal (or maxSteps are executed) and
+  //returns the SoC of the executed plan, -1 if some window has no plan
+  int run(string outputPrefix){
+    vector< pair<int,int> > origin(prob->nAgents);
+    vector< Path > executed(prob->nAgents);
+    for(int a=0;a<prob->nAgents;++a){
+      origin[a] = make_pair(prob->getStartX(a),prob->getStartY(a));
+      executed[a].push_back(origin[a]);
+    }
+    MAPFEncoder e;
+    e.verbosity = 0;
+    prob->relaxGoals = true;
+    prob->solution.clear();
+    int steps = 0;
+    int windows = 0;
+    int w = window;
+    bool failed = false;
+    while(maxSteps==0 or steps<maxSteps){
+      bool done = true;
+      for(int a=0;a<prob->nAgents and done;++a) done = atGoal(a,executed[a].back());
+      if(done) break;
+
+      double startTime = NSPACE::realTime();
+      vector< Path > paths;
+      if(not solveWindow(e,w,paths)){
+	failed = true;
+	break;
+      }
+      windows++;
+      //the last window is executed entirely
+      bool finished = true;
+      for(int a=0;a<prob->nAgents and finished;++a) finished = atGoal(a,paths[a][w]);
+      int c = finished ? w : commit;
+      if(maxSteps>0) c = min(c,maxSteps-steps);
+      vector< pair<int,int> > positions(prob->nAgents);
+      vector< pair<int,int> > previous(prob->nAgents);
+      for(int a=0;a<prob->nAgents;++a){
+	for(int t=1;t<=c;++t) executed[a].push_back(paths[a][t]);
+	previous[a] = paths[a][0];
+	positions[a] = paths[a][c];
+      }
+      steps += c;
+      printf("c Window %5d of %4d steps executed until step %6d in %8.2fs\n",windows,w,steps,NSPACE::realTime()-startTime);
+      fflush(stdout);
+      int next;
+      if(distanceToGoals(positions) < distanceToGoals(previous)) next = window;
+      else next = min(2*w,maxWindow);
+      //the rest of this plan warm starts the next window
+      prob->solution.clear();
+      for(int a=0;a<prob->nAgents;++a){
+	for(int t=c;t<=w and t-c<=next;++t){
+	  prob->solution.push_back(Assignment(0,paths[a][t].first,paths[a][t].second,a,t-c,-1));
+	}
+      }
+      prob->setStartPositions(positions);
+      w = next;
+    }
+    e.clean();
+    prob->relaxGoals = false;
+    prob->solution.clear();
+    prob->setStartPositions(origin);
+    if(failed){
+      printf("c No plan found for window %d\n",windows+1);
+      return -1;
+    }
+
+    //agents stay at their last position until the end of the plan
+    int cost = 0;
+    for(int a=0;a<prob->nAgents;++a){
+      cost += prob->getArrivalTime(a,executed[a]);
+    }
+    writePlan(executed,outputPrefix+string("_windowed.sol"));
+    printf("c Rolling horizon: %d windows of %d steps, %d steps executed\n",windows,window,steps);
+    return cost;
+  }
+};
+
+#endif
@@ -1,3 +1,6 @@
+#ifndef MAPFtoMaxSAT_hh
+#define MAPFtoMaxSAT_hh
+
 #include <assert.h>
 #include "../cardenc/clset.hh"
 #include "../cardenc/card.hh"
@@ -14,6 +17,7 @@
 #include <iostream>
 #include <queue>
 #include <climits>
+#include <algorithm>
 using namespace openwbo;
 using namespace std;
 
@@ -27,6 +31,11 @@ using namespace std;
 #define RIGHT 4
 #define INFINITE INT_MAX
 
+//creates the MaxSAT algorithm of a subproblem (LNS, rolling horizon)
+typedef MaxSAT* (*MaxSATFactory)(int algorithm, int cardinality, int graph_type, int verbosity);
+//position of an agent at every time step
+typedef vector< pair<int,int> > Path;
+
 struct Assignment{
   int type; //0 for onVars and 1 for ShiftVars
   int xPos;
@@ -64,15 +73,31 @@ struct MAPFProblem{
   int bestPossibleCost;
   vector< Agent > agentsInfo;
   vector< Assignment > solution;
+  //subproblem (see setSubproblem): paths (x,y) for t=0..occupiedBound of the
+  //agents left out, and the index of the path on every cell and time step
+  vector< Path > fixedPaths;
+  vector<int> occupant;
+  int occupiedBound;
+  //windowed planning: agents do not need to reach their goals by the bound
+  bool relaxGoals;
+  //maximum total delay over the shortest paths of a solution, -1 if unknown
+  int socSlack;
 
   int getStartX(int a)       { return agentsInfo[a].startX;  }
   int getStartY(int a)       { return agentsInfo[a].startY; }
   int getGoalX(int a)        { return agentsInfo[a].goalX;   }
   int getGoalY(int a)        { return agentsInfo[a].goalY;   }
   bool obstacle(int x, int y){ return grid[x][y].obstacle;  }
+  //fixed path on (x,y) at time t, -1 if there is none
+  int occupiedBy(int x, int y, int t){
+    if(occupant.empty() or t<0 or t>occupiedBound) return -1;
+    return occupant[(x*gridY+y)*(occupiedBound+1)+t];
+  }
   bool checkReachability(int x, int y, int a, int t, int bound){
+    if(occupiedBy(x,y,t)!=-1) return false;
 #ifdef CHECK_REACHABILITY
-    return grid[x][y].distanceToStarts[a]<=t and grid[x][y].distanceToGoals[a]<=(bound-t);
+    if(not withinSlack(x,y,a,t,socSlack)) return false;
+    return grid[x][y].distanceToStarts[a]<=t and (relaxGoals or grid[x][y].distanceToGoals[a]<=(bound-t));
 #else
     return 1;
 #endif
@@ -80,6 +105,13 @@ struct MAPFProblem{
   int getShortestPathLength(int a){
     return grid[agentsInfo[a].startX][agentsInfo[a].startY].distanceToGoals[a];
   }
+  //an agent away from its goal at time t arrives at least at t+distanceToGoal,
+  //so it cannot be there if that exceeds its shortest path plus the slack
+  bool withinSlack(int x, int y, int a, int t, int slack){
+    if(slack<0 or (x==agentsInfo[a].goalX and y==agentsInfo[a].goalY)) return true;
+    if(grid[x][y].distanceToGoals[a]==INFINITE) return false;
+    return t+grid[x][y].distanceToGoals[a] <= getShortestPathLength(a)+slack;
+  }
   vector<int> getCompatibleOperations(int x, int y){
     return grid[x][y].compatibleOperations;
   }
@@ -116,6 +148,9 @@ struct MAPFProblem{
   
   MAPFProblem(string inputFile){
     nOperations = 5;
+    relaxGoals = false;
+    socSlack = -1;
+    occupiedBound = -1;
     FILE* f = fopen(inputFile.c_str(),"rt");
     char buffer[10001];
     char* out;
@@ -178,14 +213,127 @@ struct MAPFProblem{
     //    printf("MAPFProblem read\n");
   }
 
+  //problem without agents on the grid of p, see setSubproblem
+  MAPFProblem(MAPFProblem *p){
+    problemId = p->problemId;
+    nAgents = 0;
+    nObstacles = p->nObstacles;
+    nOperations = p->nOperations;
+    gridX = p->gridX;
+    gridY = p->gridY;
+    initialBound = 1;
+    bestPossibleCost = 0;
+    relaxGoals = false;
+    socSlack = -1;
+    occupiedBound = -1;
+    grid = (Cell**)malloc(gridX*sizeof(Cell*));
+    for(int x=0;x<gridX;++x){
+      grid[x] = new Cell[gridY];
+      for(int y=0;y<gridY;++y){
+	grid[x][y].obstacle = p->grid[x][y].obstacle;
+	grid[x][y].compatibleOperations = p->grid[x][y].compatibleOperations;
+      }
+    }
+  }
+
+  MAPFProblem(const MAPFProblem &p) = delete;
+  MAPFProblem& operator=(const MAPFProblem &p) = delete;
+
+  ~MAPFProblem(){
+    for(int x=0;x<gridX;++x){
+      delete[] grid[x];
+    }
+    free(grid);
+  }
+
+  //LNS neighborhood of p: its agents are the agents of p in 'agents', in
+  //that order, and the other agents follow their paths (t=0..bound). They
+  //are not encoded, the cells they occupy are not reachable.
+  void setSubproblem(MAPFProblem &p, vector<int> &agents, vector< Path > &paths, int bound){
+    nAgents = agents.size();
+    agentsInfo.resize(nAgents);
+    initialBound = 1;
+    bestPossibleCost = 0;
+    for(int i=0;i<nAgents;++i){
+      agentsInfo[i] = p.agentsInfo[agents[i]];
+      bestPossibleCost += p.getShortestPathLength(agents[i]);
+      initialBound = max(initialBound,p.getShortestPathLength(agents[i]));
+    }
+    for(int x=0;x<gridX;++x){
+      for(int y=0;y<gridY;++y){
+	grid[x][y].distanceToGoals.resize(nAgents);
+	grid[x][y].distanceToStarts.resize(nAgents);
+	for(int i=0;i<nAgents;++i){
+	  grid[x][y].distanceToGoals[i] = p.grid[x][y].distanceToGoals[agents[i]];
+	  grid[x][y].distanceToStarts[i] = p.grid[x][y].distanceToStarts[agents[i]];
+	}
+      }
+    }
+    vector<bool> selected(p.nAgents,false);
+    for(int a:agents) selected[a] = true;
+    fixedPaths.clear();
+    occupiedBound = bound;
+    occupant.assign(gridX*gridY*(bound+1),-1);
+    for(int b=0;b<p.nAgents;++b){
+      if(selected[b]) continue;
+      for(int t=0;t<=bound;++t){
+	occupant[(paths[b][t].first*gridY+paths[b][t].second)*(bound+1)+t] = fixedPaths.size();
+      }
+      fixedPaths.push_back(paths[b]);
+    }
+    solution.clear();
+    relaxGoals = p.relaxGoals;
+    socSlack = -1;
+  }
+
   int getInitialBound(){
     return initialBound;
   }
 
+  //moves the agents to new start positions and recomputes the distances
+  void setStartPositions(vector< pair<int,int> > &positions){
+    for(int a=0;a<nAgents;++a){
+      agentsInfo[a].startX = positions[a].first;
+      agentsInfo[a].startY = positions[a].second;
+    }
+    computeShortestPaths();
+  }
+
   int getOptimumMakespan(int makespanOptimalCost){
     return(initialBound+makespanOptimalCost-bestPossibleCost-1);
   }
 
+  //extracts from the onVars assignments in solution one path per agent,
+  //padded until bound by staying at the last position
+  void getPathsFromSolution(int bound, vector< vector< pair<int,int> > > &paths){
+    vector< vector< vector< pair<int,int> > > > cells(nAgents, vector< vector< pair<int,int> > >(bound+1));
+    for(size_t i=0;i<solution.size();++i){
+      if(solution[i].type==0 and solution[i].t<=bound){
+	cells[solution[i].agent][solution[i].t].push_back(make_pair(solution[i].xPos,solution[i].yPos));
+      }
+    }
+    paths.assign(nAgents, vector< pair<int,int> >(bound+1));
+    for(int a=0;a<nAgents;++a){
+      paths[a][0] = make_pair(agentsInfo[a].startX,agentsInfo[a].startY);
+      for(int t=1;t<=bound;++t){
+	paths[a][t] = paths[a][t-1];
+	for(pair<int,int> c:cells[a][t]){
+	  if(abs(c.first-paths[a][t-1].first)+abs(c.second-paths[a][t-1].second)<=1){
+	    paths[a][t] = c;
+	    break;
+	  }
+	}
+      }
+    }
+  }
+
+  //time at which agent a reaches its goal for the last time following path
+  int getArrivalTime(int a, vector< pair<int,int> > &path){
+    int t = path.size()-1;
+    while(t>0 and path[t-1].first==agentsInfo[a].goalX and path[t-1].second==agentsInfo[a].goalY) t--;
+    return t;
+  }
+
 private:
   void computeCompatibleOperations(){
     for(int x=0;x<gridX;++x){
@@ -300,6 +448,19 @@ struct MAPFEncoder{
   int**** onVars;
   int****  shiftVars;
   int**   finalStateVars;
+  //MDD encoding: edgeVars[v*nOperations+o] moves the agent of onVar v with operation o
+  vector<int> edgeVars;
+  //false for the MDD encoding, that has no cell shift vars
+  bool cellShifts;
+  //at-most-one constraints kept as such with enc_native, they are handed to
+  //the SAT solver as cardinality constraints instead of being encoded
+  vector< vector<int> > amoGroups;
+  //distanceVars[a][k-1] is true if agent a ends the window k or more steps away from its goal
+  vector< vector<int> > distanceVars;
+  //auxiliary variables of the bitwise and bimander at-most-one encodings:
+  //each of their clauses has the negation of an input, so they are always
+  //propagated once the inputs are decided
+  vector<int> propagatedVars;
 
   map<int,VarInfo> reverseDict;
   int numVars;
@@ -312,8 +473,30 @@ struct MAPFEncoder{
   ClauseSet clauses;
   MAPFProblem *prob;
 
+  int verbosity;
+  //simplify the clause buffer after encoding (see simplifyClauses)
+  bool simplifyFormula;
+  //decision hints for the SAT solver (see addDecisionHints): 0=none,
+  //1=shortest paths, 2=the plan in p.solution when there is one
+  int heuristic;
+  //group the soft clauses by agent for PartMSU3 (see addAgentGroups)
+  bool agentGroups;
+
+  int reservedBound;
+  int reservedAgents;
+
   MAPFEncoder(){
     prob = NULL;
+    onVars = NULL;
+    shiftVars = NULL;
+    finalStateVars = NULL;
+    reservedBound = -1;
+    reservedAgents = 0;
+    cellShifts = true;
+    verbosity = 1;
+    simplifyFormula = true;
+    heuristic = 0;
+    agentGroups = false;
   }
 
   void clean(){
@@ -322,7 +505,7 @@ struct MAPFEncoder{
     if (onVars!=NULL){
       for(int x=0;x<prob->gridX;++x){
 	for(int y=0;y<prob->gridY;++y){
-	  for(int a=0;a<prob->nAgents;++a){
+	  for(int a=0;a<reservedAgents;++a){
 	    free(onVars[x][y][a]);
 	  }
 	  free(onVars[x][y]);
@@ -346,18 +529,43 @@ struct MAPFEncoder{
       shiftVars=NULL;
     }
     if(finalStateVars!=NULL){
-      for(int a=0;a<prob->nAgents;++a){
+      for(int a=0;a<reservedAgents;++a){
 	free(finalStateVars[a]);
       }
       free(finalStateVars);
       finalStateVars=NULL;
     }
-    printf("c Memory cleaned\n");
+    reservedBound = -1;
+    if(verbosity>0) printf("c Memory cleaned\n");
+  }
+
+  void resetMemory(MAPFProblem &p, int bound){
+    for(int x=0;x<p.gridX;++x){
+      for(int y=0;y<p.gridY;++y){
+	for(int a=0;a<p.nAgents;++a){
+	  memset(onVars[x][y][a],0,(bound+1)*sizeof(int));
+	}
+	for(int o=0;o<p.nOperations;++o){
+	  memset(shiftVars[x][y][o],0,bound*sizeof(int));
+	}
+      }
+    }
+    for(int a=0;a<p.nAgents;++a){
+      memset(finalStateVars[a],0,(bound+1)*sizeof(int));
+    }
   }
 
   void reserveMemory(MAPFProblem &p, int bound){
+    if(prob==&p and reservedBound==bound and reservedAgents==p.nAgents){
+      //same problem and bound (e.g. consecutive windows or LNS
+      //neighborhoods): reuse the buffers
+      resetMemory(p,bound);
+      return;
+    }
     clean();
     prob = &p;
+    reservedBound = bound;
+    reservedAgents = p.nAgents;
     //    printf("Reserving memory for map size (%d,%d), with %d agents and bound %d\n",p.gridX,p.gridY,p.nAgents,bound);
     onVars = (int****)malloc(p.gridX*sizeof(int***));
     for(int x=0;x<p.gridX;++x){
@@ -426,12 +634,14 @@ struct MAPFEncoder{
     lastOnVar = numVars;
 
     //Create shift vars
+    //cells without agents around them at time t implicitly STAY
     for(int x=0;x<p.gridX;++x){
       for(int y=0;y<p.gridY;++y){
 	if(not p.obstacle(x,y)){
 	  vector<int> op = p.getCompatibleOperations(x,y);
-	  for(int o:op){
-	    for(int t=0;t<bound;++t){
+	  for(int t=0;t<bound and cellShifts;++t){
+	    if(not activeCell(p,x,y,t)) continue;
+	    for(int o:op){
 	      numVars++;
 	      shiftVars[x][y][o][t] = numVars;
 	      reverseDict[numVars] = VarInfo(2,x,y,o,t);
@@ -453,10 +663,45 @@ struct MAPFEncoder{
       }
     }
     lastFinalStateVar = numVars;
-    numSoftClauses = numVars - lastShiftVar - p.nAgents;
+    numSoftClauses = 0;
+    for(int a=0;a<p.nAgents;++a){
+      numSoftClauses += max(0,bound-p.getShortestPathLength(a));
+    }
+
+    //Create distance vars (only when goals are relaxed)
+    distanceVars.assign(p.nAgents,vector<int>());
+    if(p.relaxGoals){
+      for(int a=0;a<p.nAgents;++a){
+	int maxDistance = 0;
+	for(int x=0;x<p.gridX;++x){
+	  for(int y=0;y<p.gridY;++y){
+	    if(onVars[x][y][a][bound]!=0){
+	      maxDistance = max(maxDistance,p.grid[x][y].distanceToGoals[a]);
+	    }
+	  }
+	}
+	for(int k=1;k<=maxDistance;++k){
+	  numVars++;
+	  distanceVars[a].push_back(numVars);
+	  reverseDict[numVars] = VarInfo(3,0,0,a,k);
+	}
+	numSoftClauses += maxDistance;
+      }
+    }
   }
 
 
+  //a cell needs shift vars at time t if some agent can be on it or on a neighbor
+  bool activeCell(MAPFProblem &p, int x, int y, int t){
+    for(int o:p.getCompatibleOperations(x,y)){
+      pair<int,int> pos = p.getNextPosWithOp(x,y,o);
+      for(int a=0;a<p.nAgents;++a){
+	if(onVars[pos.first][pos.second][a][t]!=0) return true;
+      }
+    }
+    return false;
+  }
+
   void printWCNFFormula(MAPFProblem &p, int bound, string outputFileName){
     //    printf("Printing WCNF formula\n");
     FILE* f = fopen(outputFileName.c_str(),"wt");
@@ -470,6 +715,9 @@ struct MAPFEncoder{
 	for(int t=p.getShortestPathLength(a);t<bound;++t){
 	  fprintf(f,"1 %d 0\n",finalStateVars[a][t]);
 	}
+	for(int d:distanceVars[a]){
+	  fprintf(f,"1 %d 0\n",-d);
+	}
       }
       for(int c=0;c<clauses.clauses.size();++c){
 	fprintf(f,"%d ",numSoftClauses);
@@ -482,10 +730,171 @@ struct MAPFEncoder{
     fclose(f);
   }
   
+  int edgeVar(int v, int o){ return edgeVars[v*prob->nOperations+o]; }
+
+  //number of MDD edges reaching onVar (x,y,a,t) from time t+dt
+  int countMDDEdges(MAPFProblem &p, int x, int y, int a, int t, int dt){
+    int n = 0;
+    for(int o:p.getCompatibleOperations(x,y)){
+      pair<int,int> pos = p.getNextPosWithOp(x,y,o);
+      if(onVars[pos.first][pos.second][a][t+dt]!=0) n++;
+    }
+    return n;
+  }
+
+  //MDD encoding: the reachable onVars of an agent are the vertices of its
+  //MDD and every pair of consecutive vertices gets an edge var of that agent,
+  //unless one of its endpoints has no other edge and can stand for it.
+  //Conflicts are only encoded where several agents' MDDs meet.
+  void encodeMDD(MAPFProblem &p, int bound, int encType, int problemFormulation){
+    edgeVars.assign((lastOnVar+1)*p.nOperations,0);
+    //on(a,x,y,t) -> exactly one outgoing edge, edges imply both endpoints
+    for(int x=0;x<p.gridX;++x){
+      for(int y=0;y<p.gridY;++y){
+	if(p.obstacle(x,y)) continue;
+	vector<int> operations = p.getCompatibleOperations(x,y);
+	for(int a=0;a<p.nAgents;++a){
+	  for(int t=0;t<bound;++t){
+	    int v = onVars[x][y][a][t];
+	    if(v==0) continue;
+	    bool single = countMDDEdges(p,x,y,a,t,1)==1;
+	    vector<int> edges;
+	    for(int o:operations){
+	      pair<int,int> pos = p.getNextPosWithOp(x,y,o);
+	      int w = onVars[pos.first][pos.second][a][t+1];
+	      if(w==0) continue;
+	      int e;
+	      if(single){
+		e = v;
+		vector<int> c {-v, w};
+		clauses.create_clause(c);
+	      }else if(countMDDEdges(p,pos.first,pos.second,a,t+1,-1)==1){
+		e = w;
+		vector<int> c {-w, v};
+		clauses.create_clause(c);
+	      }else{
+		e = ++numVars;
+		vector<int> c1 {-e, v};
+		vector<int> c2 {-e, w};
+		clauses.create_clause(c1);
+		clauses.create_clause(c2);
+	      }
+	      edgeVars[v*p.nOperations+o] = e;
+	      edges.push_back(e);
+	    }
+	    assert(edges.size()>0);
+	    if(single) continue;
+	    vector<int> out {-v};
+	    out.insert(out.end(),edges.begin(),edges.end());
+	    clauses.create_clause(out);
+	    encodeAtMostOne(edges,shortAMOEncoding(encType));
+	  }
+	}
+      }
+    }
+    //on(a,x,y,t) -> some incoming edge
+    for(int x=0;x<p.gridX;++x){
+      for(int y=0;y<p.gridY;++y){
+	if(p.obstacle(x,y)) continue;
+	vector<int> operations = p.getCompatibleOperations(x,y);
+	for(int a=0;a<p.nAgents;++a){
+	  for(int t=1;t<=bound;++t){
+	    int v = onVars[x][y][a][t];
+	    if(v==0) continue;
+	    vector<int> in {-v};
+	    bool tautology = false;
+	    for(int o:operations){
+	      pair<int,int> pos = p.getNextPosWithOp(x,y,o);
+	      int u = onVars[pos.first][pos.second][a][t-1];
+	      if(u==0) continue;
+	      int e = edgeVar(u,p.getOpositeOperations(o));
+	      if(e==v) tautology = true;
+	      in.push_back(e);
+	    }
+	    assert(in.size()>1);
+	    if(not tautology) clauses.create_clause(in);
+	  }
+	}
+      }
+    }
+    //an agent entering (x,y) at t+1 from (x1,y1) requires (x,y) to be empty at
+    //t or (problemFormulation 0) its occupant to move to (x1,y1)
+    for(int x=0;x<p.gridX;++x){
+      for(int y=0;y<p.gridY;++y){
+	if(p.obstacle(x,y)) continue;
+	vector<int> operations = p.getCompatibleOperations(x,y);
+	for(int t=0;t<bound;++t){
+	  vector<int> present;
+	  for(int a=0;a<p.nAgents;++a){
+	    if(onVars[x][y][a][t]!=0) present.push_back(a);
+	  }
+	  if(present.empty()) continue;
+	  int occupied = 0;
+	  for(int o:operations){
+	    if(o==STAY) continue;
+	    pair<int,int> pos = p.getNextPosWithOp(x,y,o);
+	    int back = p.getOpositeOperations(o);
+	    vector<int> entering;
+	    for(int a=0;a<p.nAgents;++a){
+	      int u = onVars[pos.first][pos.second][a][t];
+	      if(u==0 or edgeVar(u,back)==0) continue;
+	      if(present.size()==1 and present[0]==a) continue;
+	      entering.push_back(edgeVar(u,back));
+	    }
+	    if(entering.empty()) continue;
+	    if(occupied==0){
+	      occupied = ++numVars;
+	      for(int b:present){
+		vector<int> c {-onVars[x][y][b][t], occupied};
+		clauses.create_clause(c);
+	      }
+	    }
+	    int swap = 0;
+	    if(problemFormulation==0){
+	      vector<int> c {-(++numVars)};
+	      swap = numVars;
+	      for(int b:present){
+		int e = edgeVar(onVars[x][y][b][t],o);
+		if(e!=0) c.push_back(e);
+	      }
+	      clauses.create_clause(c);
+	    }
+	    for(int e:entering){
+	      vector<int> c {-e, -occupied};
+	      if(swap!=0) c.push_back(swap);
+	      clauses.create_clause(c);
+	    }
+	  }
+	}
+      }
+    }
+  }
+
+  void encodeAtMostOne(vector<int> &lits, int encType){
+    if(encType==enc_native){
+      amoGroups.push_back(lits);
+      return;
+    }
+    int firstAux = numVars+1;
+    _encode_atmost(clauses,lits,1,numVars,encType);
+    if(encType==enc_bitw or encType==enc_bimd){
+      for(int v=firstAux;v<=numVars;++v) propagatedVars.push_back(v);
+    }
+  }
+
+  //encoding of the short at-most-one constraints (shifts of a cell, edges
+  //leaving an MDD vertex), where pairwise is the best static choice
+  int shortAMOEncoding(int amoEncoding){
+    return (amoEncoding==enc_adapt or amoEncoding==enc_native) ? amoEncoding : enc_exp;
+  }
+
   void encodeHard(MAPFProblem &p, int bound, int encoding, int amoEncoding, int problemFormulation){
     clauses.clear();
+    amoGroups.clear();
+    propagatedVars.clear();
     //    printf("encoding\n");
     unsatDetected=false;
+    cellShifts = (encoding!=3);
     createVars(p,bound);
     //    printf("vars created\n");
     //relate on and finalState vars
@@ -496,7 +905,13 @@ struct MAPFEncoder{
 	int lit1 = finalStateVars[a][t];
 	int lit2 = finalStateVars[a][t+1];
 	int lit3 = onVars[p.getGoalX(a)][p.getGoalY(a)][a][t];
-	assert(lit1!=0 and lit2!=0 and lit3!=0);
+	assert(lit1!=0 and lit2!=0);
+	if(lit3==0){
+	  //the agent cannot be at its goal at time t
+	  vector<int> c {-lit1};
+	  clauses.create_clause(c);
+	  continue;
+	}
 	vector<int> c1 {-lit3,-lit2, lit1};
 	vector<int> c2 {lit2, -lit1};
 	vector<int> c3 {lit3, -lit1};
@@ -509,7 +924,7 @@ struct MAPFEncoder{
     //relate on and shift vars
     //if on(a,x,y,t) and shift(x,y,o,t) => on(a,x1,y1,t+1)
     //if on(a,x,y,t) and on(a,x1,y1,t+1) => shift(x,y,o,t) 
-    for(int x=0;x<p.gridX;++x){
+    for(int x=0;x<p.gridX and cellShifts;++x){
       for(int y=0;y<p.gridY;++y){
 	if(not p.obstacle(x,y)){
 	  for(int a=0;a<p.nAgents;++a){
@@ -559,10 +974,44 @@ struct MAPFEncoder{
       vector<int> c {onVars[startX][startY][a][0]};
       clauses.create_clause(c);
     }
+
+    //the fixed paths of a subproblem occupy their cells (see checkReachability),
+    //an agent only enters the cell a fixed path leaves, or leaves the cell a
+    //fixed path enters, by swapping with it (problemFormulation 0)
+    //on(a,x,y,t) -> -on(a,x1,y1,t+1) if fixed(b,x1,y1,t)
+    //on(a,x,y,t) -> on(a,x1,y1,t+1) if fixed(b,x1,y1,t) and fixed(b,x,y,t+1)
+    for(int x=0;x<p.gridX and not p.fixedPaths.empty();++x){
+      for(int y=0;y<p.gridY;++y){
+	if(p.obstacle(x,y)) continue;
+	for(int t=0;t<bound;++t){
+	  for(int o:p.getCompatibleOperations(x,y)){
+	    if(o==STAY) continue;
+	    pair<int,int> pos = p.getNextPosWithOp(x,y,o);
+	    int b = p.occupiedBy(pos.first,pos.second,t);
+	    if(b==-1) continue;
+	    bool enters = p.fixedPaths[b][t+1]==make_pair(x,y);
+	    for(int a=0;a<p.nAgents;++a){
+	      int v = onVars[x][y][a][t];
+	      int w = onVars[pos.first][pos.second][a][t+1];
+	      if(v==0) continue;
+	      if(not enters){
+		if(w==0) continue;
+		vector<int> c {-v, -w};
+		clauses.create_clause(c);
+	      }else{
+		vector<int> c {-v};
+		if(w!=0 and problemFormulation==0) c.push_back(w);
+		clauses.create_clause(c);
+	      }
+	    }
+	  }
+	}
+      }
+    }
     
     //agents should stay at their goal position at time bound
     //on(a,goalX(a),goalY(a),bound)
-    for(int a=0;a<p.nAgents;++a){
+    for(int a=0;a<p.nAgents && !p.relaxGoals;++a){
       int goalX = p.getGoalX(a);
       int goalY = p.getGoalY(a);
       vector<int> c1 {onVars[goalX][goalY][a][bound]};
@@ -571,7 +1020,36 @@ struct MAPFEncoder{
       clauses.create_clause(c2);
     }
 
-    if(encoding!=2){
+    //with relaxed goals the motion after bound is summarized by the distance
+    //to the goal at bound: on(a,x,y,bound) -> dist(a,k) for k<=distanceToGoal(x,y)
+    for(int a=0;a<p.nAgents && p.relaxGoals;++a){
+      int goalX = p.getGoalX(a);
+      int goalY = p.getGoalY(a);
+      if(finalStateVars[a][bound]!=0){
+	int lit1 = finalStateVars[a][bound];
+	int lit2 = onVars[goalX][goalY][a][bound];
+	assert(lit2!=0);
+	vector<int> c1 {-lit1, lit2};
+	vector<int> c2 {lit1, -lit2};
+	clauses.create_clause(c1);
+	clauses.create_clause(c2);
+      }
+      for(size_t k=1;k<distanceVars[a].size();++k){
+	vector<int> c {-distanceVars[a][k], distanceVars[a][k-1]};
+	clauses.create_clause(c);
+      }
+      for(int x=0;x<p.gridX;++x){
+	for(int y=0;y<p.gridY;++y){
+	  int d = p.grid[x][y].distanceToGoals[a];
+	  if(onVars[x][y][a][bound]!=0 and d>0){
+	    vector<int> c {-onVars[x][y][a][bound], distanceVars[a][d-1]};
+	    clauses.create_clause(c);
+	  }
+	}
+      }
+    }
+
+    if(encoding!=2 and encoding!=3){
       //agents move or stay
       //on(a,x,y,t) -> on(a,x+1,y,t+1) v on(a,x-1,y,t+1) v on(a,x,y+1,t+1) v on(a,x,y-1,t+1) v on(a,x,y,t+1)
       //agents arrive to its place from somewhere possible
@@ -617,10 +1095,11 @@ struct MAPFEncoder{
     }
     
     //no cross and not follow
-    for(int x=0;x<p.gridX;++x){
+    for(int x=0;x<p.gridX and cellShifts;++x){
       for(int y=0;y<p.gridY;++y){
 	if(not p.obstacle(x,y)){
 	  for(int t=0;t<bound;++t){
+	    if(shiftVars[x][y][STAY][t]==0) continue;
 	    vector<int> clause;
 	    vector<int> operations = p.getCompatibleOperations(x,y);
 	    for(int o:operations){
@@ -633,6 +1112,7 @@ struct MAPFEncoder{
 		  //if (x,y) shifts towards (x1,y1), (x1,y1) should stay to avoid crossing and/or following conflicts.
 		  int lit1 = shiftVars[x][y][o][t];
 		  int lit2 = shiftVars[x1][y1][STAY][t];
+		  if(lit2==0) continue; //(x1,y1) implicitly stays
 		  vector<int> c1 {-lit1, lit2};
 		  clauses.create_clause(c1);
 		}else{
@@ -641,7 +1121,8 @@ struct MAPFEncoder{
 		  int o2 = p.getOpositeOperations(o);
 		  int lit1 = shiftVars[x][y][o][t];
 		  int lit2 = shiftVars[x1][y1][o2][t];
-		  vector<int> c1 {-lit1, lit2};
+		  vector<int> c1 {-lit1};
+		  if(lit2!=0) c1.push_back(lit2); //otherwise (x1,y1) implicitly stays
 		  clauses.create_clause(c1);
 		}
 	      }
@@ -649,7 +1130,7 @@ struct MAPFEncoder{
 	    assert(clause.size()>0);
 	    //cardinality_constraint here for exactly 1 shift var per time t
 	    clauses.create_clause(clause);
-	    if(clause.size()>1) _encode_atmost(clauses,clause,1,numVars,enc_exp);
+	    if(clause.size()>1) encodeAtMostOne(clause,shortAMOEncoding(amoEncoding));
 	  }
 	}
       }
@@ -658,7 +1139,7 @@ struct MAPFEncoder{
     int encType = amoEncoding;//enc_seqc;
     //int encType = enc_cardn;
     //int encType = enc_tot;
-    if(encoding!=1){
+    if(encoding!=1 and encoding!=3){
       //agents must be at exactly one place at a time
       //is this redundant with h6 and h7?
       for(int a=0;a<p.nAgents;++a){
@@ -675,11 +1156,13 @@ struct MAPFEncoder{
 	  }
 	  assert(clause.size()>0);
 	  clauses.create_clause(clause);
-	  _encode_atmost(clauses,clause,1,numVars,encType);
+	  encodeAtMostOne(clause,encType);
 	}
       }
     }
 
+    if(encoding==3) encodeMDD(p,bound,encType,problemFormulation);
+
     //each position hosts at most one agent at a time
     for(int x=0;x<p.gridX;++x){
       for(int y=0;y<p.gridY;++y){
@@ -693,16 +1176,189 @@ struct MAPFEncoder{
 	    }
 	    if(clause.size()>1){
 	      assert(clause.size()>1);
-	      _encode_atmost(clauses,clause,1,numVars,encType);
+	      encodeAtMostOne(clause,encType);
 	    }
 	  }
 	}
       }
     }
+
+    if(simplifyFormula) simplifyClauses();
+  }
+
+  static int litIndex(int l){
+    return 2*abs(l)+(l<0);
+  }
+
+  //Post-encoding simplification of the clause buffer. The start, goal and
+  //occupancy units are propagated: satisfied clauses are dropped and false
+  //literals removed. The units themselves are kept, because the decoder reads
+  //the values of their variables. Tautologies and duplicated clauses (e.g.
+  //the no-swap binaries of a pair of cells emitted from both sides) are found
+  //by hashing the sorted clauses. Clauses containing both literals of a
+  //binary clause are removed as subsumed.
+  void simplifyClauses(){
+    vector< vector<int> > &cls = clauses.clauses;
+    vector<char> removed(cls.size(),0);
+    vector<signed char> value(numVars+1,0);
+    int satisfied = 0;
+    int falseLits = 0;
+    int duplicated = 0;
+    int subsumed = 0;
+
+    //unit propagation over occurrence lists, the clause implying a variable
+    //is its reason and is kept as a unit
+    vector< vector<int> > occurs(2*numVars+2);
+    vector<int> reason(numVars+1,-1);
+    vector<int> trail;
+    for(size_t c=0;c<cls.size();++c){
+      for(size_t i=0;i<cls[c].size();++i) occurs[litIndex(cls[c][i])].push_back(c);
+    }
+    for(size_t c=0;c<cls.size() and not unsatDetected;++c){
+      if(cls[c].size()!=1) continue;
+      int l = cls[c][0];
+      int v = value[abs(l)];
+      if(v==0){
+	value[abs(l)] = l>0 ? 1 : -1;
+	reason[abs(l)] = c;
+	trail.push_back(l);
+      }else if((v>0)!=(l>0)){
+	unsatDetected = true;
+      }
+    }
+    for(size_t t=0;t<trail.size() and not unsatDetected;++t){
+      vector<int> &occ = occurs[litIndex(-trail[t])];
+      for(size_t k=0;k<occ.size() and not unsatDetected;++k){
+	vector<int> &cl = cls[occ[k]];
+	int unassigned = 0;
+	int last = 0;
+	bool sat = false;
+	for(size_t i=0;i<cl.size() and not sat and unassigned<2;++i){
+	  int v = value[abs(cl[i])];
+	  if(v==0){
+	    unassigned++;
+	    last = cl[i];
+	  }else if((v>0)==(cl[i]>0)) sat = true;
+	}
+	if(sat or unassigned>1) continue;
+	if(unassigned==0){
+	  unsatDetected = true;
+	}else{
+	  value[abs(last)] = last>0 ? 1 : -1;
+	  reason[abs(last)] = occ[k];
+	  trail.push_back(last);
+	}
+      }
+    }
+    for(size_t c=0;c<cls.size() and not unsatDetected;++c){
+      vector<int> &cl = cls[c];
+      size_t j = 0;
+      int implied = 0;
+      bool sat = false;
+      for(size_t i=0;i<cl.size();++i){
+	int v = value[abs(cl[i])];
+	if(v==0) cl[j++] = cl[i];
+	else if((v>0)==(cl[i]>0)){
+	  sat = true;
+	  if(reason[abs(cl[i])]==(int)c) implied = cl[i];
+	}
+	else falseLits++;
+      }
+      if(implied!=0){
+	cl.assign(1,implied);
+      }else if(sat){
+	removed[c] = 1;
+	satisfied++;
+      }else{
+	cl.resize(j);
+	if(j==0) unsatDetected = true;
+      }
+    }
+    if(unsatDetected){
+      cls.clear();
+      cls.push_back(vector<int>());
+      if(verbosity>0) printf("c Clause simplification found a conflict\n");
+      return;
+    }
+
+    //sorted clauses hashed, tautologies are satisfied
+    vector< pair<size_t,size_t> > hashes;
+    for(size_t c=0;c<cls.size();++c){
+      if(removed[c]) continue;
+      vector<int> &cl = cls[c];
+      sort(cl.begin(),cl.end(),[](int a, int b){ return litIndex(a)<litIndex(b); });
+      cl.erase(unique(cl.begin(),cl.end()),cl.end());
+      size_t h = cl.size();
+      for(size_t i=0;i<cl.size();++i){
+	if(i>0 and cl[i]==-cl[i-1]){
+	  removed[c] = 1;
+	  satisfied++;
+	  break;
+	}
+	h = h*1000003 ^ (size_t)litIndex(cl[i]);
+      }
+      if(not removed[c]) hashes.push_back(make_pair(h,c));
+    }
+    sort(hashes.begin(),hashes.end());
+    for(size_t i=0;i<hashes.size();){
+      size_t k = i+1;
+      for(;k<hashes.size() and hashes[k].first==hashes[i].first;++k){
+	for(size_t l=i;l<k;++l){
+	  if(not removed[hashes[l].second] and cls[hashes[l].second]==cls[hashes[k].second]){
+	    removed[hashes[k].second] = 1;
+	    duplicated++;
+	    break;
+	  }
+	}
+      }
+      i = k;
+    }
+
+    //subsumption by binary clauses
+    vector< vector<int> > binaries(2*(numVars+1));
+    for(size_t c=0;c<cls.size();++c){
+      if(removed[c] or cls[c].size()!=2) continue;
+      binaries[litIndex(cls[c][0])].push_back(litIndex(cls[c][1]));
+      binaries[litIndex(cls[c][1])].push_back(litIndex(cls[c][0]));
+    }
+    vector<char> mark(2*(numVars+1),0);
+    for(size_t c=0;c<cls.size();++c){
+      if(removed[c] or cls[c].size()<=2) continue;
+      vector<int> &cl = cls[c];
+      for(int l:cl) mark[litIndex(l)] = 1;
+      for(size_t i=0;i<cl.size() and not removed[c];++i){
+	for(int m:binaries[litIndex(cl[i])]){
+	  if(mark[m]){
+	    removed[c] = 1;
+	    subsumed++;
+	    break;
+	  }
+	}
+      }
+      for(int l:cl) mark[litIndex(l)] = 0;
+    }
+
+    size_t j = 0;
+    for(size_t c=0;c<cls.size();++c){
+      if(not removed[c]){
+	if(j!=c) cls[j].swap(cls[c]);
+	j++;
+      }
+    }
+    cls.resize(j);
+    if(verbosity>0){
+      printf("c Clauses simplified away:%15d\n",satisfied+duplicated+subsumed);
+      printf("c   satisfied %d, duplicated %d, subsumed %d, false literals %d\n",satisfied,duplicated,subsumed,falseLits);
+    }
   }
 
   void encodeToFile(MAPFProblem &p, int bound, int encoding, string outputFileName, int amoEncoding, int problemFormulation){
     encodeHard(p,bound,encoding,amoEncoding,problemFormulation);
+    //WCNF has no at-most-one constraints
+    for(size_t g=0;g<amoGroups.size();++g){
+      _encode_atmost(clauses,amoGroups[g],1,numVars,enc_native);
+    }
+    amoGroups.clear();
     printWCNFFormula(p,bound,outputFileName);
     //    printf("Base cost is %d\n",baseCost);
   }
@@ -711,7 +1367,7 @@ struct MAPFEncoder{
     encodeHard(p,bound,encoding,amoEncoding, problemFormulation);
     MaxSATFormula* f = new MaxSATFormula();
     f->setProblemType(_UNWEIGHTED_);
-    f->setHardWeight(numSoftClauses);
+    f->setHardWeight(numSoftClauses+1);
     
     for(int a=0;a<p.nAgents;++a){
       for(int t=p.getShortestPathLength(a);t<bound;++t){
@@ -720,8 +1376,20 @@ struct MAPFEncoder{
 	while (var >= f->nVars()) f->newVar();
 	lits.push(mkLit(var));
 	f->addSoftClause(1,lits);
+	if(agentGroups) f->setSoftGroup(f->nSoft()-1,a);
+      }
+      for(int d:distanceVars[a]){
+	vec<Lit> lits;
+	int var = d - 1;
+	while (var >= f->nVars()) f->newVar();
+	lits.push(~mkLit(var));
+	f->addSoftClause(1,lits);
+	if(agentGroups) f->setSoftGroup(f->nSoft()-1,a);
       }
     }
+    //Initial 'ubCost' and 'currentWeight' of the MaxSAT algorithms.
+    f->setMaximumWeight(1);
+    f->updateSumWeights(f->nSoft());
 
     for(int c=0;c<clauses.clauses.size();++c){
       vec<Lit> lits;
@@ -734,10 +1402,117 @@ struct MAPFEncoder{
       f->addHardClause(lits);
     }
     clauses.clear();
+
+    for(size_t g=0;g<amoGroups.size();++g){
+      vec<Lit> lits;
+      for(int l:amoGroups[g]){
+	int var = abs(l) - 1;
+	while (var >= f->nVars()) f->newVar();
+	lits.push((l > 0) ? mkLit(var) : ~mkLit(var));
+      }
+      f->addCardinalityConstraint(new Card(lits,1));
+    }
+    if(amoGroups.size()>0) f->setAMOEncoding(_AMO_NATIVE_);
+    amoGroups.clear();
+
+    //preprocessing may eliminate the shift and auxiliary variables, the
+    //onVars are decoded and pruned by the upper bound
+    for(int v=1;v<=lastFinalStateVar and v<=f->nVars();++v){
+      if(v<=lastOnVar or v>lastShiftVar) f->addFrozenVar(v-1);
+    }
+
+    if(heuristic>0) addDecisionHints(p,bound,f);
+    if(agentGroups) addAgentGroups(p,bound,f);
     
     return(f);
   }
 
+  //The soft clauses of every agent are a group (set while they are added),
+  //two agents are related by the number of cells both can occupy within the
+  //bound. PartMSU3 merges first the cores of the agents whose corridors
+  //overlap the most, i.e. spatial clusters of agents.
+  void addAgentGroups(MAPFProblem &p, int bound, MaxSATFormula *f){
+    vector<double> shared(p.nAgents*p.nAgents,0);
+    vector<int> agents;
+    for(int x=0;x<p.gridX;++x){
+      for(int y=0;y<p.gridY;++y){
+	if(p.obstacle(x,y)) continue;
+	agents.clear();
+	for(int a=0;a<p.nAgents;++a){
+	  for(int t=0;t<=bound;++t){
+	    if(onVars[x][y][a][t]!=0){
+	      agents.push_back(a);
+	      break;
+	    }
+	  }
+	}
+	for(size_t i=0;i<agents.size();++i){
+	  for(size_t j=i+1;j<agents.size();++j){
+	    shared[agents[i]*p.nAgents+agents[j]] += 1;
+	  }
+	}
+      }
+    }
+    for(int a=0;a<p.nAgents;++a){
+      for(int b=a+1;b<p.nAgents;++b){
+	if(shared[a*p.nAgents+b]>0) f->addSoftGroupEdge(a,b,shared[a*p.nAgents+b]);
+      }
+    }
+  }
+
+  //Seeds the decision heuristic of the SAT solver: every agent follows a
+  //shortest path (or its path in the plan stored in p.solution) and then
+  //stays at its goal. The onVars of these paths are decided true first,
+  //agent by agent from the longest shortest path, each in time order (time
+  //step by time step for all the agents needed more conflicts on c20). The
+  //activities are below the first VSIDS bump, so the conflicts take over
+  //the order quickly. The auxiliary variables of the at-most-one encodings
+  //that are always propagated are not decided.
+  void addDecisionHints(MAPFProblem &p, int bound, MaxSATFormula *f){
+    vector< vector< pair<int,int> > > plan;
+    vector<bool> planned(p.nAgents,false);
+    if(heuristic==2 and p.solution.size()>0){
+      p.getPathsFromSolution(bound,plan);
+      for(size_t i=0;i<p.solution.size();++i){
+	if(p.solution[i].type==0) planned[p.solution[i].agent] = true;
+      }
+    }
+    vector<int> agents(p.nAgents);
+    for(int a=0;a<p.nAgents;++a) agents[a] = a;
+    sort(agents.begin(),agents.end(),[&p](int a, int b){ return p.getShortestPathLength(a)<p.getShortestPathLength(b); });
+    vector<int> rank(p.nAgents);
+    for(int r=0;r<p.nAgents;++r) rank[agents[r]] = r+1;
+
+    double scale = 1.0/((p.nAgents+1)*(bound+1));
+    for(int a=0;a<p.nAgents;++a){
+      int sp = p.getShortestPathLength(a);
+      for(int t=1;t<=bound;++t){
+	double activity = (rank[a]*(bound+1)+bound+1-t)*scale;
+	if(planned[a]){
+	  int v = onVars[plan[a][t].first][plan[a][t].second][a][t];
+	  if(v!=0 and v<=f->nVars()) f->addDecisionHint(v-1,activity,l_True);
+	  continue;
+	}
+	for(int x=0;x<p.gridX;++x){
+	  for(int y=0;y<p.gridY;++y){
+	    int v = onVars[x][y][a][t];
+	    if(v==0 or v>f->nVars()) continue;
+	    if(p.grid[x][y].distanceToStarts[a]==min(t,sp) and p.grid[x][y].distanceToGoals[a]==max(sp-t,0)){
+	      f->addDecisionHint(v-1,activity,l_True);
+	    }
+	  }
+	}
+      }
+      for(int t=sp;t<=bound;++t){
+	int v = finalStateVars[a][t];
+	if(v!=0 and v<=f->nVars()) f->addDecisionHint(v-1,0,l_True);
+      }
+    }
+    for(int v:propagatedVars){
+      if(v<=f->nVars()) f->addNonDecisionVar(v-1);
+    }
+  }
+
   void getModelFromSolution(vector< Assignment > &sol,vec<Lit> &partialModel){
     for(int i=0;i<sol.size();++i){
       if(sol[i].type==0){
@@ -809,8 +1584,66 @@ struct MAPFEncoder{
     fclose(o);
     return(cost);
   }
+
+  //reads the path of every agent from the model without touching files nor p.solution
+  void decodePathsFromOpenWBO(MAPFProblem &p,int bound,MaxSAT* solver,vector< vector< pair<int,int> > > &paths){
+    paths.assign(p.nAgents, vector< pair<int,int> >(bound+1));
+    for(int a=0;a<p.nAgents;++a){
+      paths[a][0] = make_pair(p.getStartX(a),p.getStartY(a));
+      for(int t=1;t<=bound;++t){
+	paths[a][t] = paths[a][t-1];
+	for(int o:p.getCompatibleOperations(paths[a][t-1].first,paths[a][t-1].second)){
+	  pair<int,int> pos = p.getNextPosWithOp(paths[a][t-1].first,paths[a][t-1].second,o);
+	  int var = onVars[pos.first][pos.second][a][t];
+	  if(var!=0 and solver->getValue(var-1)>0){
+	    paths[a][t] = pos;
+	    break;
+	  }
+	}
+      }
+    }
+  }
 };
 
+//When the MaxSAT search finds a plan with total delay U, better plans have
+//every agent within a detour budget of U, so the positions outside it are
+//removed from the formula as the upper bound improves.
+struct MAPFSlackPruner : public UBListener{
+  MAPFProblem *prob;
+  MAPFEncoder *enc;
+  int bound;
+  int slack;
+  int pruned;
 
+  MAPFSlackPruner(MAPFProblem &p, MAPFEncoder &e, int bnd){
+    prob = &p;
+    enc = &e;
+    bound = bnd;
+    slack = p.socSlack;
+    pruned = 0;
+  }
 
+  void upperBoundImproved(uint64_t cost, vec<Lit> &units){
+    if(prob->relaxGoals or (slack>=0 and cost>=(uint64_t)slack)) return;
+    for(int x=0;x<prob->gridX;++x){
+      for(int y=0;y<prob->gridY;++y){
+	if(prob->obstacle(x,y)) continue;
+	for(int a=0;a<prob->nAgents;++a){
+	  for(int t=0;t<=bound;++t){
+	    int var = enc->onVars[x][y][a][t];
+	    if(var!=0 and not prob->withinSlack(x,y,a,t,cost)){
+	      //positions removed by a previous bound are already units
+	      if(slack<0 or prob->withinSlack(x,y,a,t,slack)){
+		units.push(~mkLit(var-1));
+		pruned++;
+	      }
+	    }
+	  }
+	}
+      }
+    }
+    slack = cost;
+  }
+};
 
+#endif
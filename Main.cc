@@ -41,6 +41,9 @@
 #include <string>
 #include <vector>
 #include "MAPFEncoder/MAPFtoMaxSAT.hh"
+#include "MAPFEncoder/MAPFLNS.hh"
+#include "MAPFEncoder/MAPFRollingHorizon.hh"
+#include "MAPFEncoder/MAPFCheckpoint.hh"
 
 #ifdef SIMP
 #include "simp/SimpSolver.h"
@@ -56,6 +59,8 @@
 #include "algorithms/Alg_PartMSU3.h"
 #include "algorithms/Alg_MSU3.h"
 #include "algorithms/Alg_OLL.h"
+#include "algorithms/Alg_WBO.h"
+#include "algorithms/Alg_Hybrid.h"
 
 #define VER1_(x) #x
 #define VER_(x) VER1_(x)
@@ -67,13 +72,18 @@ using NSPACE::OutOfMemoryException;
 using NSPACE::IntOption;
 using NSPACE::BoolOption;
 using NSPACE::StringOption;
+using NSPACE::DoubleOption;
 using NSPACE::IntRange;
+using NSPACE::DoubleRange;
 using NSPACE::parseOptions;
 using namespace openwbo;
 
 //=================================================================================================
 
 static MaxSAT *mxsolver;
+static MAPFCheckpoint *checkpoint = NULL;
+//phase 1 stops at the first plan of the makespan optimal bound (LNS)
+static bool firstPlanOnly = false;
 
 double totalTimeEncoding;
 double totalTimeSolving;
@@ -93,10 +103,22 @@ static void SIGINT_exit(int signum) {
     printf("ts %.2lf\n",totalTimeSolving+control_time-begin_solving_time);
   }
   printf("rt %lf\n",control_time-initial_time);
-  mxsolver->printAnswer(_UNKNOWN_);
+  if(mxsolver!=NULL) mxsolver->printAnswer(_UNKNOWN_);
+  else printf("s UNKNOWN\n");
   exit(_SATISFIABLE_);
 }
 
+// The search in progress is saved before terminating, between two searches
+// the checkpoint of the next bound is already saved.
+static void SIGTERM_checkpoint(int signum) {
+  if(checkpoint->inSearch()) checkpoint->request(true);
+  else SIGINT_exit(signum);
+}
+
+static void SIGALRM_checkpoint(int) {
+  checkpoint->request(false);
+}
+
 //=================================================================================================
 #if !defined(_MSC_VER) && !defined(__MINGW32__)
 void limitMemory(uint64_t max_mem_mb)
@@ -153,17 +175,22 @@ void limitTime(uint32_t /*max_cpu_time*/)
 pair<int,int> encodeAndSolve(MAPFProblem &p, MAPFEncoder &e, int bound, int encoding, int amoEncoding, string outputPrefix, bool soc_optimal_bound, int problemFormulation){
   double control_time;
   begin_encoding_time = cpuTime();
-  MaxSATFormula *maxsat_formula = e.encodeForOpenWBO(p,bound,encoding,amoEncoding,problemFormulation);
+  MaxSATFormula *maxsat_formula = checkpoint!=NULL ? checkpoint->restoreFormula(e,bound,encoding) : NULL;
+  if(maxsat_formula==NULL) maxsat_formula = e.encodeForOpenWBO(p,bound,encoding,amoEncoding,problemFormulation);
+  else printf("c Formula restored from the checkpoint\n");
   printf("c Encoded with bound:%20d\n", bound);
   printf("c Number of variables:%19d\n", maxsat_formula->nVars());
   printf("c Number of hard clauses:%16d\n", maxsat_formula->nHard());
   printf("c Number of soft clauses:%16d\n", maxsat_formula->nSoft());
+  if(maxsat_formula->nCard()>0) printf("c Number of AMO constraints:%13d\n", maxsat_formula->nCard());
   printf("c Base cost is:%26d\n", e.baseCost);
+  if(amoEncoding==enc_adapt) adaptive_report();
   end_encoding_time = cpuTime();
   totalTimeEncoding += end_encoding_time-begin_encoding_time;
   printf("c Elapsed time[s]:%23.2f\n", end_encoding_time - initial_time);
   mxsolver->setInitialTime(end_encoding_time);
   begin_solving_time = cpuTime();
+  if(checkpoint!=NULL) checkpoint->startSearch(mxsolver,maxsat_formula,bound);
   mxsolver->loadFormula(maxsat_formula);
   printf("c Formula loaded\n");
   if(p.solution.size()>0){
@@ -171,8 +198,22 @@ pair<int,int> encodeAndSolve(MAPFProblem &p, MAPFEncoder &e, int bound, int enco
     e.getModelFromSolution(p.solution,partialModel);
     mxsolver->loadInitialPartialModel(partialModel);
   }
+  if(checkpoint!=NULL){
+    checkpoint->restoreSearch(e,mxsolver);
+    mxsolver->setCheckpointListener(checkpoint);
+  }
+  MAPFSlackPruner pruner(p,e,bound);
+  MAPFFirstPlan firstPlan(mxsolver);
+  if(firstPlanOnly) mxsolver->setUBListener(&firstPlan);
+  else mxsolver->setUBListener(&pruner);
   int ret = (int)mxsolver->search();
+  mxsolver->setUBListener(NULL);
+  if(checkpoint!=NULL){
+    mxsolver->setCheckpointListener(NULL);
+    checkpoint->endSearch();
+  }
   printf("c Search finished\n");
+  printf("c Pruned by upper bound:%17d\n", pruner.pruned);
   if(ret==_UNSATISFIABLE_)
     printf("c Solved with result: UNSAT\n");
   else if(ret==_OPTIMUM_)
@@ -186,7 +227,7 @@ pair<int,int> encodeAndSolve(MAPFProblem &p, MAPFEncoder &e, int bound, int enco
   totalTimeSolving += end_solving_time-begin_solving_time;
 
   pair<int,int> result = make_pair(ret,INT_MAX);
-  if ( ret == _OPTIMUM_ ) {
+  if ( ret == _OPTIMUM_ or ret == _SATISFIABLE_ ) {
     outputPrefix += soc_optimal_bound?string("_soc_optimal.sol"):string("_makespan_optimal.sol");
     int cost = e.decodeFromOpenWBO(p,bound,mxsolver,outputPrefix);
     result.second = cost;
@@ -205,11 +246,20 @@ void copyMakespanFileToSOCFile(string prefix){
   system(command.c_str());
 }
 
+//threads used by PartMSU3 for the leaves of its guide tree
+static int partThreads = 1;
+//threads used by PartMSU3 for the local moves of the community detection
+static int louvainThreads = 1;
+
 MaxSAT* createMaxSATSolver(int algorithm,int cardinality, int graph_type,int verbosity ){
   MaxSAT *S = NULL;
+  PartMSU3 *P = NULL;
   switch(algorithm){
   case _ALGORITHM_PART_MSU3_:
-    S = new PartMSU3(verbosity, _PART_BINARY_, graph_type,cardinality);
+    P = new PartMSU3(verbosity, _PART_BINARY_, graph_type,cardinality);
+    P->setThreads(partThreads);
+    P->setCommunityThreads(louvainThreads);
+    S = P;
     break;
   case _ALGORITHM_LINEAR_SU_:
     S = new LinearSU(verbosity,true,cardinality, 1);
@@ -220,6 +270,12 @@ MaxSAT* createMaxSATSolver(int algorithm,int cardinality, int graph_type,int ver
   case _ALGORITHM_OLL_:
     S = new OLL(verbosity, cardinality);
     break;
+  case _ALGORITHM_WBO_:
+    S = new WBO(verbosity);
+    break;
+  case _ALGORITHM_BEST_:
+    S = new Hybrid(verbosity);
+    break;
   default:
     printf("ERROR: Algorithm not availble\n");
     return(0);
@@ -257,11 +313,32 @@ int main(int argc, char **argv) {
     IntOption mem_lim("MAPFSAT", "mem-lim", "Limit on memory usage in megabytes.\n", 0, IntRange(0, INT32_MAX));
     IntOption algorithm1("Open-WBO", "algorithm1","Search algorithm (1=linear-su,2=msu3,3=part-msu3,4=oll).\n", 2, IntRange(1, 4));
     IntOption algorithm2("Open-WBO", "algorithm2","Search algorithm (0=wbo,1=linear-su,2=msu3,3=part-msu3,4=oll,5=best).\n", 1, IntRange(0, 5));
+    IntOption sat_solver1("Open-WBO", "sat-solver1","SAT solver of phase 1 (0=glucose4.1,1=glucose4.0,2=minisat2.2).\n", 0, IntRange(0, 2));
+    IntOption sat_solver2("Open-WBO", "sat-solver2","SAT solver of phase 2 (0=glucose4.1,1=glucose4.0,2=minisat2.2).\n", 0, IntRange(0, 2));
     IntOption cardinality("Encodings", "cardinality","Cardinality encoding (0=cardinality networks, 1=totalizer, 2=modulo totalizer).\n", 1, IntRange(0, 2));
-    IntOption encoding("MAPF encoding", "encoding", "MAPF encoding (0=FULL,1=MINIMAL1,2=MINIMAL2).\n", 1, IntRange(0, 2));
-    IntOption amoEncoding("At-most one encoding", "amoEncoding", "AMO encoding (0=pairwise,1=seqc_enc,2=sortn_enc,3=cardn_enc,4=bitwise_enc,5=ladd_enc,6=tot_enc,7=mtot_enc,8=kmtot).\n", 4, IntRange(0, 8));
-    IntOption graph_type("PartMSU3", "graph-type","Graph type (0=vig, 1=cvig, 2=res) (only for unsat-based partition algorithms).",0, IntRange(0, 2));
+    IntOption encoding("MAPF encoding", "encoding", "MAPF encoding (0=FULL,1=MINIMAL1,2=MINIMAL2,3=MDD).\n", 1, IntRange(0, 3));
+    IntOption amoEncoding("At-most one encoding", "amoEncoding", "AMO encoding (0=pairwise,1=seqc_enc,2=sortn_enc,3=cardn_enc,4=bitwise_enc,5=ladd_enc,6=tot_enc,7=mtot_enc,8=kmtot,9=product,10=commander,11=bimander,12=adaptive,13=native).\n", 4, IntRange(0, 13));
+    IntOption graph_type("PartMSU3", "graph-type","Graph type (0=vig, 1=cvig, 2=res, 3=agents) (only for unsat-based partition algorithms).",0, IntRange(0, 3));
+    IntOption part_threads("PartMSU3", "part-threads","Number of threads that solve the leaves of the partition tree in parallel.\n",1, IntRange(1, 256));
+    IntOption louvain_threads("PartMSU3", "louvain-threads","Number of threads for the local moves of the community detection (1=sequential).\n",1, IntRange(1, 256));
     IntOption problemFormulation("Problem formulation", "problemFormulation", "Formulation of the problem (0=without follow conflict,1=with follow conflict,).\n", 0, IntRange(0, 1));
+    IntOption lns("LNS", "lns", "Improve the makespan optimal plan with Large Neighborhood Search instead of exact SoC optimization (0=off, 1=on).\n", 0, IntRange(0, 1));
+    IntOption lns_algorithm("LNS", "lns-algorithm","Search algorithm for the neighborhoods (1=linear-su,2=msu3,3=part-msu3,4=oll).\n", 2, IntRange(1, 4));
+    IntOption lns_neighborhood("LNS", "lns-neighborhood", "Neighborhood selection (0=random,1=conflict-adjacent,2=spatial window,3=mixed).\n", 3, IntRange(0, 3));
+    IntOption lns_size("LNS", "lns-size", "Number of agents re-planned in each neighborhood.\n", 8, IntRange(1, INT32_MAX));
+    IntOption lns_threads("LNS", "lns-threads", "Number of neighborhoods solved in parallel.\n", 4, IntRange(1, 256));
+    IntOption lns_time("LNS", "lns-time", "Wall clock time limit for LNS in seconds.\n", 60, IntRange(1, INT32_MAX));
+    DoubleOption lns_neighborhood_time("LNS", "lns-neighborhood-time", "Wall clock time limit for the search of one neighborhood in seconds.\n", 2, DoubleRange(0, false, HUGE_VAL, false));
+    IntOption simplify("MAPF encoding", "simplify", "Remove satisfied, duplicated and subsumed clauses after encoding (0=off, 1=on).\n", 1, IntRange(0, 1));
+    IntOption heuristic("MAPF encoding", "heuristic", "Decision hints for the SAT solver (0=none, 1=shortest paths, 2=shortest paths, then the plan of the last bound).\n", 0, IntRange(0, 2));
+    IntOption preprocess("Open-WBO", "preprocess", "Simplify the formula of every bound with variable elimination, subsumption and equivalent literal substitution (0=off, 1=on).\n", 0, IntRange(0, 1));
+    IntOption window("Rolling horizon", "window", "Plan with a rolling horizon of this many time steps instead of the full makespan (0=off).\n", 0, IntRange(0, INT32_MAX));
+    IntOption window_commit("Rolling horizon", "window-commit", "Time steps executed from each window plan (0=half of the window).\n", 0, IntRange(0, INT32_MAX));
+    IntOption window_steps("Rolling horizon", "window-steps", "Maximum number of time steps executed (0=until all agents reach their goals).\n", 1000, IntRange(0, INT32_MAX));
+    StringOption checkpoint_file("Checkpoint", "checkpoint", "Save the state of the search in this file at every bound, periodically and on SIGTERM.\n");
+    IntOption checkpoint_interval("Checkpoint", "checkpoint-interval", "Wall clock seconds between two checkpoints of a search (0=only on SIGTERM).\n", 600, IntRange(0, INT32_MAX));
+    IntOption checkpoint_learnts("Checkpoint", "checkpoint-learnts", "Save the learnt clauses up to this LBD and the variable activities of the SAT solver (0=off).\n", 0, IntRange(0, INT32_MAX));
+    IntOption resume("Checkpoint", "resume", "Resume the search from the checkpoint (0=off, 1=on).\n", 0, IntRange(0, 1));
     parseOptions(argc, argv, true);
     printf("c\nc===============================SOLVING CONFIGURATION===============================\n");
     printf("c\tProblem formulation:");
@@ -274,7 +351,8 @@ int main(int argc, char **argv) {
     switch(encoding){
     case 0: printf("\t\t\tFull redundant encoding\n");break;
     case 1: printf("\t\t\tMinimal with step-by-step constraints\n");break;
-    case 2: printf("\t\t\tMinimal imposing agents stay at exacly one spot at a time\n");
+    case 2: printf("\t\t\tMinimal imposing agents stay at exacly one spot at a time\n");break;
+    case 3: printf("\t\t\tPer agent MDD edges\n");
     }
     
     printf("c\tMaxSAT Algorithm Phase1:");
@@ -286,12 +364,15 @@ int main(int argc, char **argv) {
       case 0: printf("vig\n");break;
       case 1: printf("cvig\n");break;
       case 2: printf("res\n");break;
+      case 3: printf("agents\n");break;
       }
+      break;
     case 4: printf("\tOLL\n");
     }
 
     printf("c\tMaxSAT Algorithm Phase2:");
     switch(algorithm2){
+    case 0: printf("\tWBO\n");break;
     case 1: printf("\tLinear SU\n");break;
     case 2: printf("\tMSU3\n");break;
     case 3: printf("\tPART-MSU3 with graph_type");
@@ -299,21 +380,46 @@ int main(int argc, char **argv) {
       case 0: printf("vig\n");break;
       case 1: printf("cvig\n");break;
       case 2: printf("res\n");break;
+      case 3: printf("agents\n");break;
       }
-    case 4: printf("\tOLL\n");
+      break;
+    case 4: printf("\tOLL\n");break;
+    case 5: printf("\tHybrid MSU3/Linear SU\n");
+    }
+
+    const char *satSolverNames[] = {"Glucose 4.1","Glucose 4.0","MiniSat 2.2"};
+    printf("c\tSAT solver Phase1:\t\t%s\n",satSolverNames[sat_solver1]);
+    printf("c\tSAT solver Phase2:\t\t%s\n",satSolverNames[sat_solver2]);
+
+    if(preprocess){
+      printf("c\tPreprocessing:\t\t\tVariable elimination, subsumption, equivalent literals\n");
+    }
+    if(window>0){
+      printf("c\tPlanning:\t\t\tRolling horizon with window %d\n",(int)window);
+    }
+    if(lns){
+      printf("c\tSoC optimization:\t\tLNS with %d agents per neighborhood, %d threads, %ds (%gs per neighborhood)\n",(int)lns_size,(int)lns_threads,(int)lns_time,(double)lns_neighborhood_time);
+    }
+    if((const char*)checkpoint_file!=NULL){
+      printf("c\tCheckpoints:\t\t\t%s every %ds%s\n",(const char*)checkpoint_file,(int)checkpoint_interval,resume?", resumed":"");
     }
 
     printf("c\tAt-most one encoding:");
-    switch(encoding){
+    switch(amoEncoding){
     case 0: printf("\t\tPairwise\n");break;
     case 1: printf("\t\tSequencial Counter\n");break;
     case 2: printf("\t\tSorting Networks\n");break;
     case 3: printf("\t\tCardinality Networks\n");break;
     case 4: printf("\t\tBitwise\n");break;
-    case 5: printf("\t\tAdder Networks\n");break;      
+    case 5: printf("\t\tLadder\n");break;
     case 6: printf("\t\tTotalizer\n");break;
     case 7: printf("\t\tM-Totalizer\n");break;
-    case 8: printf("\t\tKM-Totalizer\n");
+    case 8: printf("\t\tKM-Totalizer\n");break;
+    case 9: printf("\t\tProduct\n");break;
+    case 10: printf("\t\tCommander\n");break;
+    case 11: printf("\t\tBimander\n");break;
+    case 12: printf("\t\tAdaptive to the constraint size\n");break;
+    case 13: printf("\t\tNative in the SAT solver\n");
     }
     printf("c===================================================================================\nc\n");
     // Try to set resource limits:
@@ -335,25 +441,86 @@ int main(int argc, char **argv) {
 
     MAPFProblem p(argv[1]);
     MAPFEncoder e;
+    e.simplifyFormula = simplify;
+    e.heuristic = heuristic;
+    e.agentGroups = (graph_type==3);
+    partThreads = part_threads;
+    firstPlanOnly = lns;
+    louvainThreads = louvain_threads;
     int bound = p.getInitialBound();
+    int phase = 1;
+
+    //checkpoints cover the exact makespan and SoC search, neither the rolling
+    //horizon nor LNS
+    if((const char*)checkpoint_file!=NULL and window==0){
+      string key = string(argv[1])+" encoding="+to_string(encoding)+" amoEncoding="+to_string(amoEncoding)+
+	" problemFormulation="+to_string(problemFormulation)+" simplify="+to_string(simplify)+
+	" heuristic="+to_string(heuristic)+" agentGroups="+to_string(graph_type==3);
+      checkpoint = new MAPFCheckpoint(p,string(checkpoint_file),key,checkpoint_interval,checkpoint_learnts);
+      checkpoint->terminate = SIGINT_exit;
+      if(resume and checkpoint->resume()){
+	phase = checkpoint->phase;
+	bound = checkpoint->bound;
+      }
+      signal(SIGTERM, SIGTERM_checkpoint);
+      if(checkpoint_interval>0){
+	signal(SIGALRM, SIGALRM_checkpoint);
+	alarm(checkpoint_interval);
+      }
+    }
 
-    while(1){
+    if(window>0){
+      MAPFRollingHorizon r(p,createMaxSATSolver,window,window_commit,encoding,amoEncoding,problemFormulation,algorithm1,cardinality);
+      r.maxSteps = window_steps;
+      int cost = r.run(argv[2]);
+      if(cost<0) printf("s UNKNOWN\n");
+      else printf("s Solution with cost %d printed to file\n",cost);
+    }
+    while(window==0 and phase==1){
+      if(checkpoint!=NULL) checkpoint->startBound(phase,bound);
       mxsolver = createMaxSATSolver(algorithm1,cardinality,graph_type,verbosity);
+      mxsolver->setPreprocessing(preprocess);
+      mxsolver->setSATSolver(sat_solver1);
       pair<int,int> ret = encodeAndSolve(p,e,bound,encoding,amoEncoding,argv[2],false,problemFormulation);
       delete(mxsolver);
-      if ( ret.first == _OPTIMUM_ ) {
+      mxsolver = NULL;
+      //with LNS the first plan of the bound, SoC optimal otherwise
+      if ( ret.first == _OPTIMUM_ or ret.first == _SATISFIABLE_ ) {
 	int opt_bound = p.getOptimumMakespan(ret.second);
-	if(opt_bound <= bound){
+	if(lns){
+	  MAPFLNS l(p,createMaxSATSolver,opt_bound,encoding,amoEncoding,problemFormulation,lns_algorithm,cardinality);
+	  l.neighborhoodType = lns_neighborhood;
+	  l.neighborhoodSize = lns_size;
+	  l.nThreads = lns_threads;
+	  l.timeLimit = lns_time;
+	  l.neighborhoodTime = lns_neighborhood_time;
+	  int cost = l.run(argv[2]);
+	  printf("s Solution with cost %d printed to file\n",cost);
+	}else if(opt_bound <= bound){
 	  copyMakespanFileToSOCFile(argv[2]);
 	}else{
-	  mxsolver = createMaxSATSolver(algorithm2,cardinality,graph_type,verbosity);
-	  ret = encodeAndSolve(p,e,opt_bound,encoding,amoEncoding,argv[2],true,problemFormulation);
-	  delete(mxsolver);
+	  //no agent of a better plan deviates more than the delay of this one
+	  p.socSlack = ret.second - p.bestPossibleCost;
+	  phase = 2;
+	  bound = opt_bound;
 	}
 	break;
       }
       bound++;
     }
+    if(phase==2){
+      if(checkpoint!=NULL) checkpoint->startBound(phase,bound);
+      mxsolver = createMaxSATSolver(algorithm2,cardinality,graph_type,verbosity);
+      mxsolver->setPreprocessing(preprocess);
+      mxsolver->setSATSolver(sat_solver2);
+      encodeAndSolve(p,e,bound,encoding,amoEncoding,argv[2],true,problemFormulation);
+      delete(mxsolver);
+      mxsolver = NULL;
+    }
+    if(checkpoint!=NULL){
+      alarm(0);
+      checkpoint->finish();
+    }
     printf("te %.2lf\n",totalTimeEncoding);
     printf("ts %.2lf\n",totalTimeSolving);
     printf("rt %.2lf\n",cpuTime()-initial_time);
@@ -53,56 +53,139 @@ void MaxSAT::setInitialTime(double initial) {
  //
  ************************************************************************************************/
 
-// Creates an empty SAT Solver.
+// Creates an empty SAT Solver of the type set with 'setSATSolver()'.
 Solver *MaxSAT::newSATSolver() {
 
 #ifdef SIMP
-  NSPACE::SimpSolver *S = new NSPACE::SimpSolver();
+  Solver *S = createSATSolver(satSolverType, true);
 #else
-  Solver *S = new Solver();
+  Solver *S = createSATSolver(satSolverType, preprocessing);
 #endif
 
-  return (Solver *)S;
+#ifdef INCREMENTAL
+  // Restarts keep the assumption levels. No variable is declared as a
+  // selector (initNbInitialVars): the relaxation and encoding variables are
+  // propagated like any other, and leaving them out of the LBD of the learnt
+  // clauses made the MAPF instances slower.
+  S->setIncrementalMode();
+#endif
+
+  return S;
 }
 
 // Creates a new variable in the SAT solver.
-void MaxSAT::newSATVariable(Solver *S) {
-
-#ifdef SIMP
-  ((NSPACE::SimpSolver *)S)->newVar();
-#else
-  S->newVar();
-#endif
-}
+void MaxSAT::newSATVariable(Solver *S) { S->newVar(); }
 
 // Makes sure the underlying SAT solver has the given amount of variables
 // reserved.
 void MaxSAT::reserveSATVariables(Solver *S, unsigned maxVariable) {
-#ifdef SAT_HAS_RESERVATION
-#ifdef SIMP
-  ((NSPACE::SimpSolver *)S)->reserveVars(maxVariable);
-#else
   S->reserveVars(maxVariable);
-#endif
-#endif
 }
 
 // Solve the formula that is currently loaded in the SAT solver with a set of
 // assumptions and with the option to use preprocessing for 'simp'.
 lbool MaxSAT::searchSATSolver(Solver *S, vec<Lit> &assumptions, bool pre) {
 
-// Currently preprocessing is disabled by default.
+  if (S->nSolves() == 0) {
+    applyDecisionHints(S);
+    if (checkpointListener != NULL)
+      checkpointListener->restoreSolver(S);
+  }
+  seedBestPhase(S);
+
+// A checkpoint is saved between two calls or after interrupting one, the
+// interrupted call then goes on from the state of the solver. 'runningSolver'
+// is set before 'stopped' is read, so that 'stopSearch()' either interrupts
+// the call or prevents it.
+  if (checkpointListener != NULL && checkpointListener->checkpointRequested())
+    checkpointListener->saveCheckpoint(this, S);
+  S->clearInterrupt();
+  runningSolver = S;
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  lbool res = stopped ? l_Undef : solveSATSolver(S, assumptions, pre);
+  while (res == l_Undef && !stopped && checkpointListener != NULL &&
+         checkpointListener->checkpointRequested()) {
+    runningSolver = NULL;
+    S->clearInterrupt();
+    checkpointListener->saveCheckpoint(this, S);
+    runningSolver = S;
+    res = solveSATSolver(S, assumptions, pre);
+  }
+  runningSolver = NULL;
+  return res;
+}
+
+// Answer of a search stopped by 'stopSearch()', with the best model so far.
+StatusCode MaxSAT::stoppedAnswer() {
+  printAnswer(_UNKNOWN_);
+  return searchStatus;
+}
+
+// Calls the SAT solver once.
+lbool MaxSAT::solveSATSolver(Solver *S, vec<Lit> &assumptions, bool pre) {
+
 // Variable elimination cannot be done on relaxation variables nor on variables
-// that belong to soft clauses. To preprocessing to be used those variables
-// should be frozen.
+// that belong to soft clauses. With 'preprocessing' those variables are frozen
+// and the solver is simplified once, at its first call. Later calls only
+// extend the models to the eliminated variables. Solvers that cannot
+// eliminate variables ignore 'preprocessing'.
+  if (preprocessing && S->canEliminate()) {
+    freezeSATVariables(S);
+    lbool res = S->solveLimited(assumptions, true, true);
+    if (print) {
+      printf("c Eliminated variables:%17d\n", S->nEliminated());
+      printf("c Substituted variables:%16d\n", S->nSubstituted());
+    }
+    return res;
+  }
 
-#ifdef SIMP
-  lbool res = ((NSPACE::SimpSolver *)S)->solveLimited(assumptions, pre);
-#else
-  lbool res = S->solveLimited(assumptions);
-#endif
+  return S->solveLimited(assumptions, pre);
+}
 
-  return res;
+// Sets the initial activities and phases of the variables with hints, and
+// leaves the auxiliary variables that the formula allows out of the
+// decisions. Preprocessing resolves away their defining clauses, so they
+// stay decision variables with it.
+void MaxSAT::applyDecisionHints(Solver *S) {
+  vec<int> &vars = maxsat_formula->getHintVars();
+  vec<double> &activities = maxsat_formula->getHintActivities();
+  vec<lbool> &phases = maxsat_formula->getHintPhases();
+  for (int i = 0; i < vars.size(); i++) {
+    S->setActivity(vars[i], activities[i]);
+    if (phases[i] != l_Undef)
+      S->setInitialPolarity(vars[i], phases[i] == l_False);
+  }
+  if (!preprocessing) {
+    vec<int> &aux = maxsat_formula->getNonDecisionVars();
+    for (int i = 0; i < aux.size(); i++)
+      S->setDecisionVar(aux[i], false);
+  }
+}
+
+// Makes the best model found so far the best phase of the SAT solver, so that
+// its search restarts near the incumbent.
+void MaxSAT::seedBestPhase(Solver *S) {
+  for (int i = 0; i < model.size() && i < S->nVars(); i++)
+    S->setBestPhase(i, model[i] == l_False);
+}
+
+// Freezes the variables of the soft clauses, their relaxation and assumption
+// variables and the variables the formula asks for (e.g. to decode models or
+// to add clauses later on).
+void MaxSAT::freezeSATVariables(Solver *S) {
+  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+    Soft &soft = maxsat_formula->getSoftClause(i);
+    for (int j = 0; j < soft.clause.size(); j++)
+      S->setFrozen(var(soft.clause[j]), true);
+    for (int j = 0; j < soft.relaxation_vars.size(); j++)
+      S->setFrozen(var(soft.relaxation_vars[j]), true);
+    if (soft.assumption_var != lit_Undef)
+      S->setFrozen(var(soft.assumption_var), true);
+  }
+
+  vec<int> &frozen = maxsat_formula->getFrozenVars();
+  for (int i = 0; i < frozen.size(); i++)
+    S->setFrozen(frozen[i], true);
 }
 
 // Solve the formula without assumptions.
@@ -144,6 +227,30 @@ void MaxSAT::saveModel(vec<lbool> &currentModel) {
     model.push(currentModel[i]);
 }
 
+/*_________________________________________________________________________________________________
+  |
+  |  notifyUpperBound : (S : Solver *) (cost : uint64_t)  ->  [void]
+  |
+  |  Description:
+  |
+  |    Informs the upper bound listener (if any) that only solutions of cost
+  |    at most 'cost' are of interest and adds the unit clauses it returns to
+  |    the SAT solver.
+  |
+  |  Pre-conditions:
+  |    * Assumes that 'S' is at decision level 0.
+  |
+  |________________________________________________________________________________________________@*/
+void MaxSAT::notifyUpperBound(Solver *S, uint64_t cost) {
+  if (ubListener == NULL)
+    return;
+
+  vec<Lit> units;
+  ubListener->upperBoundImproved(cost, units);
+  for (int i = 0; i < units.size(); i++)
+    S->addClause(units[i]);
+}
+
 /*_________________________________________________________________________________________________
   |
   |  computeCostModel : (currentModel : vec<lbool>&) (weight : int) ->
@@ -30,16 +30,14 @@
 #ifndef MaxSAT_h
 #define MaxSAT_h
 
-#ifdef SIMP
 #include "simp/SimpSolver.h"
-#else
-#include "core/Solver.h"
-#endif
 
 #include "MaxSATFormula.h"
 #include "MaxTypes.h"
+#include "SATSolver.h"
 #include "utils/System.h"
 #include <algorithm>
+#include <atomic>
 #include <map>
 #include <set>
 #include <utility>
@@ -50,11 +48,33 @@ using NSPACE::Lit;
 using NSPACE::lit_Undef;
 using NSPACE::mkLit;
 using NSPACE::lbool;
-using NSPACE::Solver;
+using openwbo::Solver;
 using NSPACE::cpuTime;
 
 namespace openwbo {
 
+// Receives the upper bound improvements of the search. Implementations may
+// return unit clauses over the variables of the original formula that hold in
+// every solution whose cost does not exceed 'cost'.
+class UBListener {
+public:
+  virtual ~UBListener() {}
+  virtual void upperBoundImproved(uint64_t cost, vec<Lit> &units) = 0;
+};
+
+class MaxSAT;
+
+// Saves the state of the search when it is requested, before a call to the SAT
+// solver or after the call was stopped by 'MaxSAT::interruptSearch()'. New SAT
+// solvers can be seeded with the clauses and activities of a previous run.
+class CheckpointListener {
+public:
+  virtual ~CheckpointListener() {}
+  virtual bool checkpointRequested() = 0;
+  virtual void saveCheckpoint(MaxSAT *mx, Solver *S) = 0;
+  virtual void restoreSolver(Solver *S) = 0;
+};
+
 class MaxSAT {
 
 public:
@@ -81,6 +101,12 @@ public:
     print_soft = false;
     print = false;
     unsat_soft_file = NULL;
+    ubListener = NULL;
+    checkpointListener = NULL;
+    runningSolver = NULL;
+    stopped = false;
+    preprocessing = false;
+    satSolverType = _SAT_GLUCOSE41_;
   }
 
   MaxSAT() {
@@ -105,6 +131,12 @@ public:
     print_soft = false;
     print = false;
     unsat_soft_file = NULL;
+    ubListener = NULL;
+    checkpointListener = NULL;
+    runningSolver = NULL;
+    stopped = false;
+    preprocessing = false;
+    satSolverType = _SAT_GLUCOSE41_;
   }
 
   virtual void reset(){
@@ -140,6 +172,7 @@ public:
 
   virtual StatusCode search();      // MaxSAT search.
   void printAnswer(int type); // Print the answer.
+  StatusCode stoppedAnswer(); // Answer of a search stopped by 'stopSearch()'.
 
   // Tests if a MaxSAT formula has a lexicographical optimization criterion.
   bool isBMO(bool cache = true);
@@ -181,6 +214,39 @@ public:
   void setPrint(bool doPrint) { print = doPrint; }
   bool getPrint() { return print; }
 
+  void setUBListener(UBListener *listener) { ubListener = listener; }
+
+  void setCheckpointListener(CheckpointListener *listener) {
+    checkpointListener = listener;
+  }
+
+  // Stops the running call to the SAT solver at its next restart so that the
+  // checkpoint listener can save the search, the call is then resumed. Safe to
+  // use from a signal handler.
+  void interruptSearch() {
+    Solver *S = runningSolver;
+    if (S != NULL)
+      S->interrupt();
+  }
+
+  // Stops the search for good: the running call to the SAT solver is
+  // interrupted and no other call is made, the search returns with the best
+  // model found so far (_SATISFIABLE_) or _UNKNOWN_. Safe to use from another
+  // thread or from a UB listener.
+  void stopSearch() {
+    stopped = true;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    interruptSearch();
+  }
+
+  // Best model and bounds of the search so far.
+  vec<lbool> &getModel() { return model; }
+  uint64_t getUpperBound() { return ubCost; }
+  uint64_t getLowerBound() { return lbCost; }
+
+  void setPreprocessing(bool pre) { preprocessing = pre; }
+  void setSATSolver(int type) { satSolverType = type; }
+
   void setPrintSoft(const char* file) { 
     if (file != NULL){
       unsat_soft_file = (char*)malloc(sizeof(char) * (sizeof(file)));
@@ -226,6 +292,13 @@ protected:
   // Solves the formula that is currently loaded in the SAT solver.
   lbool searchSATSolver(Solver *S, vec<Lit> &assumptions, bool pre = false);
   lbool searchSATSolver(Solver *S, bool pre = false);
+  lbool solveSATSolver(Solver *S, vec<Lit> &assumptions, bool pre);
+  // Freezes the variables that the search refers to after simplification.
+  void freezeSATVariables(Solver *S);
+  // Seeds the decision heuristic with the hints of the formula.
+  void applyDecisionHints(Solver *S);
+  // Seeds the best phase of the SAT solver with the best model found so far.
+  void seedBestPhase(Solver *S);
 
   void newSATVariable(Solver *S); // Creates a new variable in the SAT solver.
 
@@ -260,6 +333,12 @@ protected:
   bool print;         // Controls if data should be printed at all
   bool print_soft;    // Controls if the unsatified soft clauses are printed at the end.
   char * unsat_soft_file;  // Name of the file where the unsatisfied soft clauses will be printed.
+  UBListener *ubListener;  // Notified when the upper bound improves.
+  CheckpointListener *checkpointListener; // Saves the search when requested.
+  Solver *volatile runningSolver; // SAT solver of the call in progress.
+  volatile bool stopped; // Set by 'stopSearch()'.
+  bool preprocessing; // Simplifies every SAT solver once before its first call.
+  int satSolverType;  // SAT solver of the search ('_SAT_*_').
 
   // Different weights that corresponds to each function in the BMO algorithm.
   std::vector<uint64_t> orderWeights;
@@ -267,6 +346,8 @@ protected:
   // Utils for model management
   //
   void saveModel(vec<lbool> &currentModel); // Saves a Model.
+  // Adds to 'S' the units implied for solutions of cost at most 'cost'.
+  void notifyUpperBound(Solver *S, uint64_t cost);
   // Compute the cost of a model.
   uint64_t computeCostModel(vec<lbool> &currentModel,
                             uint64_t weight = UINT64_MAX);
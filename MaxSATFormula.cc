@@ -51,6 +51,23 @@ MaxSATFormula *MaxSATFormula::copyMaxSATFormula() {
   copymx->setMaximumWeight(getMaximumWeight());
   copymx->setHardWeight(getHardWeight());
 
+  for (int i = 0; i < nCard(); i++)
+    copymx->addCardinalityConstraint(new Card(getCardinalityConstraint(i)->_lits,
+                                              getCardinalityConstraint(i)->_rhs));
+  copymx->setAMOEncoding(getAMOEncoding());
+  for (int i = 0; i < frozen_vars.size(); i++)
+    copymx->addFrozenVar(frozen_vars[i]);
+  for (int i = 0; i < hint_vars.size(); i++)
+    copymx->addDecisionHint(hint_vars[i], hint_activities[i], hint_phases[i]);
+  for (int i = 0; i < non_decision_vars.size(); i++)
+    copymx->addNonDecisionVar(non_decision_vars[i]);
+  for (int i = 0; i < soft_groups.size(); i++)
+    if (soft_groups[i] != -1)
+      copymx->setSoftGroup(i, soft_groups[i]);
+  for (int i = 0; i < nSoftGroupEdges(); i++)
+    copymx->addSoftGroupEdge(group_edges_from[i], group_edges_to[i],
+                             group_edges_weight[i]);
+
   return copymx;
 }
 
@@ -177,6 +194,11 @@ void MaxSATFormula::addPBConstraint(PB *p) {
   }
 }
 
+// Adds a new cardinality constraint (<= rhs) to the formula. Takes ownership.
+void MaxSATFormula::addCardinalityConstraint(Card *card) {
+  cardinality_constraints.push(card);
+}
+
 int MaxSATFormula::newVarName(char *varName) {
   int id = varID(varName);
   if (id == var_Undef) {
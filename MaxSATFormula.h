@@ -44,6 +44,7 @@ using NSPACE::vec;
 using NSPACE::Lit;
 using NSPACE::lit_Undef;
 using NSPACE::mkLit;
+using NSPACE::lbool;
 
 namespace openwbo {
 
@@ -96,6 +97,8 @@ public:
         max_soft_weight(0) {
     objective_function = NULL;
     format = _FORMAT_MAXSAT_;
+    amo_encoding = _AMO_LADDER_;
+    n_soft_groups = 0;
   }
 
   ~MaxSATFormula() {
@@ -185,6 +188,63 @@ public:
 
   int getFormat() { return format; }
 
+  /*! Variables that must not be eliminated by preprocessing. */
+  void addFrozenVar(int v) { frozen_vars.push(v); }
+
+  vec<int> &getFrozenVars() { return frozen_vars; }
+
+  /*! Hints for the decision heuristic: initial activity and phase (l_Undef
+   * keeps the default one) of a variable. */
+  void addDecisionHint(int v, double activity, lbool phase) {
+    hint_vars.push(v);
+    hint_activities.push(activity);
+    hint_phases.push(phase);
+  }
+
+  vec<int> &getHintVars() { return hint_vars; }
+  vec<double> &getHintActivities() { return hint_activities; }
+  vec<lbool> &getHintPhases() { return hint_phases; }
+
+  /*! Auxiliary variables that every clause with them also constrains through
+   * a decision variable, they are never chosen as decisions. */
+  void addNonDecisionVar(int v) { non_decision_vars.push(v); }
+
+  vec<int> &getNonDecisionVars() { return non_decision_vars; }
+
+  /*! Partition of the soft clauses given by the encoding (e.g. one group per
+   * agent), used by PartMSU3 instead of a graph of the formula. */
+  void setSoftGroup(int pos, int group) {
+    soft_groups.growTo(pos + 1, -1);
+    soft_groups[pos] = group;
+    if (group >= n_soft_groups)
+      n_soft_groups = group + 1;
+  }
+
+  /*! Group of the i-soft clause, -1 if it has none. */
+  int getSoftGroup(int pos) {
+    return pos < soft_groups.size() ? soft_groups[pos] : -1;
+  }
+
+  int nSoftGroups() { return n_soft_groups; }
+
+  /*! Weighted edge between two related groups (e.g. agents whose paths may
+   * meet), groups with heavy edges are merged first. */
+  void addSoftGroupEdge(int g1, int g2, double weight) {
+    group_edges_from.push(g1);
+    group_edges_to.push(g2);
+    group_edges_weight.push(weight);
+  }
+
+  int nSoftGroupEdges() { return group_edges_from.size(); }
+  int getSoftGroupEdgeFrom(int i) { return group_edges_from[i]; }
+  int getSoftGroupEdgeTo(int i) { return group_edges_to[i]; }
+  double getSoftGroupEdgeWeight(int i) { return group_edges_weight[i]; }
+
+  /*! Encoding of the cardinality constraints with rhs 1. */
+  void setAMOEncoding(int enc) { amo_encoding = enc; }
+
+  int getAMOEncoding() { return amo_encoding; }
+
   indexMap &getIndexToName() { return _indexToName; }
 
 protected:
@@ -198,6 +258,16 @@ protected:
   PBObjFunction *objective_function;   //<! Objective function for PB.
   vec<Card *> cardinality_constraints; //<! Stores the cardinality constraints.
   vec<PB *> pb_constraints;            //<! Stores the PB constraints.
+  vec<int> frozen_vars;                //<! Variables kept by preprocessing.
+  vec<int> hint_vars;                  //<! Variables with decision hints.
+  vec<double> hint_activities;         //<! Initial activities of hint_vars.
+  vec<lbool> hint_phases;              //<! Initial phases of hint_vars.
+  vec<int> non_decision_vars;          //<! Variables left out of the decisions.
+  vec<int> soft_groups;                //<! Group of each soft clause.
+  int n_soft_groups;                   //<! Number of soft clause groups.
+  vec<int> group_edges_from;           //<! Edges between the soft groups.
+  vec<int> group_edges_to;
+  vec<double> group_edges_weight;
 
   // Properties of the MaxSAT formula
   //
@@ -218,6 +288,7 @@ protected:
   // Format
   //
   int format;
+  int amo_encoding; //<! Encoding of the at-most-one constraints.
 };
 
 } // namespace openwbo
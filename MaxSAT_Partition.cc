@@ -60,12 +60,13 @@ void MaxSAT_Partition::init() {
 
   if (_graph != NULL)
     delete _graph;
+  _graph = NULL;
   if (_solver != NULL)
     delete _solver;
-  _solver = newSATSolver();
+  _solver = new NSPACE::Solver();
 
   for (int i = 0; i < maxsat_formula->nVars(); i++)
-    newSATVariable(_solver);
+    _solver->newVar();
 
   for (int i = 0; i < maxsat_formula->nHard(); i++)
     _solver->addClause(maxsat_formula->getHardClause(i).clause);
@@ -93,7 +94,11 @@ void MaxSAT_Partition::split(int mode, int graphType) {
 
   if (mode == RAND_MODE)
     splitRandom();
+  else if (graphType == GROUP_GRAPH && maxsat_formula->nSoftGroups() > 0)
+    buildGroupPartitions();
   else {
+    if (graphType == GROUP_GRAPH)
+      graphType = RES_GRAPH;
     _graph = buildGraph(true, graphType);
 
     if (_graph == NULL) {
@@ -196,6 +201,66 @@ void MaxSAT_Partition::buildSinglePartition() {
   }
 }
 
+// The partitions are the soft clause groups of the formula, without the
+// groups whose soft clauses are all satisfied or falsified by the hard
+// clauses. The groups and their edges are the graph of the partitions, so no
+// graph of the formula is built and no communities are searched for.
+void MaxSAT_Partition::buildGroupPartitions() {
+  vec<int> renumber(maxsat_formula->nSoftGroups(), -1);
+
+  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+    int g = maxsat_formula->getSoftGroup(i);
+    if (g == -1 || !unassignedLiterals(maxsat_formula->getSoftClause(i).clause))
+      _graphMappingSoft[i] = -1;
+    else {
+      if (renumber[g] == -1) {
+        renumber[g] = _nPartitions++;
+        _partitions.push();
+      }
+      _graphMappingSoft[i] = renumber[g];
+      _partitions[renumber[g]].sclauses.push(i);
+    }
+  }
+
+  // Ungrouped soft clauses are kept in a partition of their own
+  int ungrouped = -1;
+  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+    if (maxsat_formula->getSoftGroup(i) == -1 &&
+        unassignedLiterals(maxsat_formula->getSoftClause(i).clause)) {
+      if (ungrouped == -1) {
+        ungrouped = _nPartitions++;
+        _partitions.push();
+      }
+      _graphMappingSoft[i] = ungrouped;
+      _partitions[ungrouped].sclauses.push(i);
+    }
+  }
+
+  if (_nPartitions == 0) {
+    buildSinglePartition();
+    return;
+  }
+
+  // The hard clauses and variables are not assigned to partitions
+  for (int i = 0; i < maxsat_formula->nVars(); i++)
+    _graphMappingVar[i] = -1;
+  for (int i = 0; i < maxsat_formula->nHard(); i++)
+    _graphMappingHard[i] = -1;
+
+  _graph = new Graph(_nPartitions);
+  for (int i = 0; i < maxsat_formula->nSoftGroupEdges(); i++) {
+    int u = renumber[maxsat_formula->getSoftGroupEdgeFrom(i)];
+    int v = renumber[maxsat_formula->getSoftGroupEdgeTo(i)];
+    if (u == -1 || v == -1 || u == v)
+      continue;
+    _graph->addEdge(u, v, maxsat_formula->getSoftGroupEdgeWeight(i));
+    _graph->addEdge(v, u, maxsat_formula->getSoftGroupEdgeWeight(i));
+  }
+  _graph->mergeDuplicatedEdges();
+
+  _gc.setCommunities(_graph);
+}
+
 void MaxSAT_Partition::buildVIGPartitions() {
   vec<int> w;
   w.growTo(_nPartitions);
@@ -39,7 +39,12 @@ using NSPACE::Var;
 
 namespace openwbo {
 
-enum graphType_ { VIG_GRAPH = 0, CVIG_GRAPH = 1, RES_GRAPH = 2 };
+enum graphType_ {
+  VIG_GRAPH = 0,
+  CVIG_GRAPH = 1,
+  RES_GRAPH = 2,
+  GROUP_GRAPH = 3 // Soft clause groups of the formula (see setSoftGroup)
+};
 
 typedef struct {
   vec<int> vars;
@@ -63,6 +68,9 @@ public:
   void setRandomSeed(int n) { _randomSeed = n; }
   int getRandomSeed() { return _randomSeed; }
 
+  // Set number of threads for the local moves of the community detection
+  void setCommunityThreads(int n) { _gc.setThreads(n); }
+
   double getModularity() { return _gc.getModularity(); }
   int nPartitions() { return _nPartitions; }
   int varPartition(Var v) { return _graphMappingVar[v]; }
@@ -86,10 +94,10 @@ public:
     return _partitions[index].hclauses;
   }
 
-  const vec<int> &adjacentPartitions(int index) {
+  Graph::Range<int> adjacentPartitions(int index) {
     return _gc.adjCommunities(index);
   }
-  const vec<double> &adjacentPartitionWeights(int index) {
+  Graph::Range<double> adjacentPartitionWeights(int index) {
     return _gc.adjCommunityWeights(index);
   }
 
@@ -114,6 +122,7 @@ protected:
 
   void buildPartitions(int graphType);
   void buildSinglePartition();
+  void buildGroupPartitions();
   void buildVIGPartitions();
   void buildCVIGPartitions();
   void buildRESPartitions();
@@ -131,7 +140,9 @@ protected:
   void printClause(vec<Lit> &sc);
 
 protected:
-  Solver *_solver;
+  // Only propagates the hard clauses at the root, whatever the SAT solver of
+  // the search.
+  NSPACE::Solver *_solver;
 
   vec<int> _graphMappingVar;
   vec<int> _graphMappingHard;
@@ -72,9 +72,10 @@ enum {
   _INCREMENTAL_ITERATIVE_
 };
 enum { _CARD_CNETWORKS_ = 0, _CARD_TOTALIZER_, _CARD_MTOTALIZER_ };
-enum { _AMO_LADDER_ = 0 };
+enum { _AMO_LADDER_ = 0, _AMO_NATIVE_ };
 enum { _PB_SWC_ = 0, _PB_GTE_, _PB_ADDER_ };
 enum { _PART_SEQUENTIAL_ = 0, _PART_SEQUENTIAL_SORTED_, _PART_BINARY_ };
+enum { _SAT_GLUCOSE41_ = 0, _SAT_GLUCOSE40_, _SAT_MINISAT22_ };
 
 }
 #endif
@@ -0,0 +1,52 @@
+/*!
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "SATSolver.h"
+#include "MaxTypes.h"
+#include "satsolvers/Sat_Glucose41.h"
+#include "satsolvers/Sat_IPASIR.h"
+
+using namespace openwbo;
+
+bool SATSolver::addAtMostOne(const vec<Lit> &ps) {
+  bool ok = true;
+  for (int i = 0; i < ps.size(); i++)
+    for (int j = i + 1; j < ps.size(); j++)
+      ok &= addClause(~ps[i], ~ps[j]);
+  return ok;
+}
+
+SATSolver *openwbo::createSATSolver(int type, bool simplify) {
+  switch (type) {
+  case _SAT_GLUCOSE41_:
+    return new Glucose41(simplify);
+  case _SAT_GLUCOSE40_:
+    return new IPASIRSolver(glucose40IPASIR());
+  case _SAT_MINISAT22_:
+    return new IPASIRSolver(minisat22IPASIR());
+  default:
+    throw MaxSATException(__FILE__, __LINE__, "Invalid SAT solver");
+  }
+}
@@ -0,0 +1,150 @@
+/*!
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef SATSolver_h
+#define SATSolver_h
+
+#include "core/SolverTypes.h"
+#include "mtl/Vec.h"
+
+using NSPACE::vec;
+using NSPACE::Lit;
+using NSPACE::Var;
+using NSPACE::lbool;
+
+namespace openwbo {
+
+//=================================================================================================
+// Incremental SAT solver used by the MaxSAT algorithms and the encodings, in
+// the spirit of IPASIR: variables and clauses are only added, every call to
+// solve takes its own assumptions and leaves either a model or the failed
+// assumptions. The remaining methods are hints for the search, a solver that
+// has no use for one ignores it.
+class SATSolver {
+
+public:
+  virtual ~SATSolver() {}
+
+  virtual const char *name() = 0;
+
+  // Problem specification
+  //
+  virtual Var newVar() = 0;
+  virtual int nVars() = 0;
+  // Makes room for 'maxVariable' variables (see 'newVar()').
+  virtual void reserveVars(Var maxVariable) {}
+  // Adds a clause, 'ps' may be modified. Returns false if the formula became
+  // unsatisfiable.
+  virtual bool addClause_(vec<Lit> &ps) = 0;
+  // Adds the constraint that at most one literal of 'ps' is true. Solvers
+  // without native at-most-one constraints get the pairwise clauses, so that
+  // no variable is added behind the back of the caller.
+  virtual bool addAtMostOne(const vec<Lit> &ps);
+
+  bool addClause(const vec<Lit> &ps) {
+    ps.copyTo(add_tmp);
+    return addClause_(add_tmp);
+  }
+  bool addClause(Lit p) {
+    add_tmp.clear();
+    add_tmp.push(p);
+    return addClause_(add_tmp);
+  }
+  bool addClause(Lit p, Lit q) {
+    add_tmp.clear();
+    add_tmp.push(p);
+    add_tmp.push(q);
+    return addClause_(add_tmp);
+  }
+  bool addClause(Lit p, Lit q, Lit r) {
+    add_tmp.clear();
+    add_tmp.push(p);
+    add_tmp.push(q);
+    add_tmp.push(r);
+    return addClause_(add_tmp);
+  }
+
+  // Solving
+  //
+  // Searches for a model under the assumptions within the budget. 'do_simp'
+  // and 'turn_off_simp' are those of the simplifying solvers (see
+  // 'canEliminate()').
+  virtual lbool solveLimited(const vec<Lit> &assumps, bool do_simp = false,
+                             bool turn_off_simp = false) = 0;
+  // Number of calls to 'solveLimited()' so far.
+  virtual int nSolves() = 0;
+  // Stops the next calls after 'x' conflicts each.
+  virtual void setConfBudget(int64_t x) = 0;
+  virtual void budgetOff() = 0;
+  // Stops the call in progress, safe to call from a signal handler or
+  // another thread.
+  virtual void interrupt() = 0;
+  virtual void clearInterrupt() = 0;
+
+  // Results of the last call: the model if it was satisfiable, the negation
+  // of the failed assumptions if it was not (empty if the formula is
+  // unsatisfiable without them).
+  vec<lbool> model;
+  vec<Lit> conflict;
+
+  // Search hints
+  //
+  virtual void setIncrementalMode() {}
+  virtual void setDecisionVar(Var v, bool b) {}
+  virtual void setActivity(Var v, double act) {}
+  virtual double getActivity(Var v) { return 0; }
+  // Fixed polarity, initial polarity and polarity of the best known model
+  // (true means false, as in Glucose).
+  virtual void setPolarity(Var v, bool b) {}
+  virtual void setInitialPolarity(Var v, bool b) {}
+  virtual void setBestPhase(Var v, bool b) {}
+
+  // Variable elimination
+  //
+  // True if the next call may eliminate variables, which then have to be
+  // frozen with 'setFrozen()' to be referred to later on.
+  virtual bool canEliminate() { return false; }
+  virtual void setFrozen(Var v, bool b) {}
+  virtual int nEliminated() { return 0; }
+  virtual int nSubstituted() { return 0; }
+
+  // Appends the root level units and the learnt clauses over the variables
+  // below 'nv' with an LBD up to 'max_lbd', each one closed by lit_Undef.
+  virtual void exportLearnts(vec<Lit> &out, int nv, unsigned int max_lbd) {}
+
+protected:
+  vec<Lit> add_tmp;
+};
+
+// The algorithms and the encodings only see the interface.
+typedef SATSolver Solver;
+
+// Creates a solver of the given '_SAT_*_' type, with variable elimination if
+// 'simplify' and the solver supports it.
+SATSolver *createSATSolver(int type, bool simplify);
+
+} // namespace openwbo
+
+#endif
@@ -0,0 +1,270 @@
+/*!
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "Alg_Hybrid.h"
+
+using namespace openwbo;
+
+/*_________________________________________________________________________________________________
+  |
+  |  hybridSearch : [void] ->  [StatusCode]
+  |
+  |  Description:
+  |
+  |    Alternates between the lower bound side (MSU3 with the iterative
+  |    totalizer) and the upper bound side (linear search on the same
+  |    totalizer) until both bounds meet. The first time the upper bound side
+  |    runs, the soft clauses that are not in a core yet are joined to the
+  |    totalizer; from then on the lower bound side refutes 'lbCost' on all of
+  |    them. A side keeps the solver as long as its calls finish within its
+  |    budget.
+  |
+  |  For further details see:
+  |    *  Jeremias Berg, Emir Demirovic, Peter J. Stuckey: Core-Boosted Linear
+  |       Search for Incomplete MaxSAT. CPAIOR 2019: 39-56
+  |
+  |  Post-conditions:
+  |    * 'ubCost' and 'lbCost' are updated.
+  |    * 'nbSatisfiable' is updated.
+  |    * 'nbCores' is updated.
+  |
+  |________________________________________________________________________________________________@*/
+StatusCode Hybrid::hybridSearch() {
+  initRelaxation();
+  solver = rebuildSolver();
+  encoder.setIncremental(_INCREMENTAL_ITERATIVE_);
+
+  activeSoft.growTo(maxsat_formula->nSoft(), false);
+  for (int i = 0; i < maxsat_formula->nSoft(); i++)
+    coreMapping[getAssumptionLit(i)] = i;
+
+  // The initial partial model only guides the first call.
+  vec<Lit> assumptions;
+  initialPartialModel.copyTo(assumptions);
+  lbool res = searchSATSolver(solver, assumptions);
+  if (res == l_False && assumptions.size() > 0) {
+    assumptions.clear();
+    res = searchSATSolver(solver, assumptions);
+  }
+  if (res == l_Undef)
+    return stoppedAnswer();
+  if (res == l_False) {
+    printAnswer(_UNSATISFIABLE_);
+    return _UNSATISFIABLE_;
+  }
+  newModel();
+
+  int64_t lbBudget = initialBudget;
+  int64_t ubBudget = initialBudget;
+  bool lowerSide = true;
+  while (lbCost < ubCost) {
+    res = lowerSide ? lowerBoundStep(lbBudget) : upperBoundStep(ubBudget);
+    if (res != l_Undef)
+      continue;
+    if (stopped) {
+      solver->budgetOff();
+      return stoppedAnswer();
+    }
+
+    if (lowerSide)
+      lbBudget *= 2;
+    else
+      ubBudget *= 2;
+    lowerSide = !lowerSide;
+    if (verbosity > 0)
+      printf("c Switching to the %s bound (budget %" PRId64 " conflicts)\n",
+             lowerSide ? "lower" : "upper", lowerSide ? lbBudget : ubBudget);
+  }
+
+  solver->budgetOff();
+  printAnswer(_OPTIMUM_);
+  return _OPTIMUM_;
+}
+
+// Public search method
+StatusCode Hybrid::search() {
+
+  if (maxsat_formula->getProblemType() == _WEIGHTED_) {
+    if(print) {
+      printf("Error: Currently algorithm Hybrid does not support weighted "
+             "MaxSAT instances.\n");
+      printf("s UNKNOWN\n");
+    }
+    throw MaxSATException(__FILE__, __LINE__, "Hybrid does not support weighted");
+    return _UNKNOWN_;
+  }
+
+  printConfiguration();
+  return hybridSearch();
+}
+
+/************************************************************************************************
+ //
+ // Search steps
+ //
+ ************************************************************************************************/
+
+// A model of this step costs at most 'lbCost', so it is optimal.
+lbool Hybrid::lowerBoundStep(int64_t budget) {
+  vec<Lit> assumptions;
+  if (allActive)
+    boundAssumptions(lbCost, assumptions);
+  else {
+    for (int i = 0; i < maxsat_formula->nSoft(); i++)
+      if (!activeSoft[i])
+        assumptions.push(~getAssumptionLit(i));
+    for (int i = 0; i < encodingAssumptions.size(); i++)
+      assumptions.push(encodingAssumptions[i]);
+  }
+
+  solver->setConfBudget(budget);
+  lbool res = searchSATSolver(solver, assumptions);
+  if (res == l_True) {
+    newModel();
+    assert(ubCost == lbCost);
+  }
+  if (res != l_False)
+    return res;
+
+  nbCores++;
+  sumSizeCores += solver->conflict.size();
+  // Unsatisfiable without assumptions: the clauses of the upper bound
+  // listener leave nothing cheaper than the best model.
+  if (solver->conflict.size() == 0) {
+    lbCost = ubCost;
+    return res;
+  }
+
+  lbCost++;
+  if (verbosity > 0)
+    printf("c LB : %-12" PRIu64 "\n", lbCost);
+  if (allActive || lbCost == ubCost)
+    return res;
+
+  vec<Lit> joinObjFunction;
+  for (int i = 0; i < solver->conflict.size(); i++) {
+    if (coreMapping.find(solver->conflict[i]) != coreMapping.end()) {
+      assert(!activeSoft[coreMapping[solver->conflict[i]]]);
+      activeSoft[coreMapping[solver->conflict[i]]] = true;
+      joinObjFunction.push(getRelaxationLit(coreMapping[solver->conflict[i]]));
+    }
+  }
+
+  vec<Lit> currentObjFunction;
+  for (int i = 0; i < maxsat_formula->nSoft(); i++)
+    if (activeSoft[i])
+      currentObjFunction.push(getRelaxationLit(i));
+
+  if (!encoder.hasCardEncoding()) {
+    if (lbCost != (unsigned)currentObjFunction.size()) {
+      encoder.buildCardinality(solver, currentObjFunction, lbCost);
+      encoder.incUpdateCardinality(solver, currentObjFunction, lbCost,
+                                   encodingAssumptions);
+    }
+  } else {
+    if (joinObjFunction.size() > 0)
+      encoder.joinEncoding(solver, joinObjFunction, lbCost);
+    encoder.incUpdateCardinality(solver, currentObjFunction, lbCost,
+                                 encodingAssumptions);
+  }
+  return res;
+}
+
+// Without a model cheaper than 'ubCost' the best model is optimal.
+lbool Hybrid::upperBoundStep(int64_t budget) {
+  activateAll();
+  vec<Lit> assumptions;
+  boundAssumptions(ubCost - 1, assumptions);
+
+  solver->setConfBudget(budget);
+  lbool res = searchSATSolver(solver, assumptions);
+  if (res == l_True)
+    newModel();
+  else if (res == l_False) {
+    nbCores++;
+    lbCost = ubCost;
+  }
+  return res;
+}
+
+/************************************************************************************************
+ //
+ // Other protected methods
+ //
+ ************************************************************************************************/
+
+void Hybrid::activateAll() {
+  if (allActive)
+    return;
+  allActive = true;
+
+  vec<Lit> join;
+  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+    if (!activeSoft[i]) {
+      activeSoft[i] = true;
+      join.push(getRelaxationLit(i));
+    }
+  }
+  // Without an encoding yet, 'boundAssumptions()' builds it on all of them.
+  if (join.size() > 0 && encoder.hasCardEncoding())
+    encoder.joinEncoding(solver, join, lbCost);
+}
+
+void Hybrid::boundAssumptions(int64_t rhs, vec<Lit> &assumptions) {
+  assert(allActive);
+  // The totalizer would fix the bound 0 with unit clauses.
+  if (rhs == 0) {
+    for (int i = 0; i < objFunction.size(); i++)
+      assumptions.push(~objFunction[i]);
+    return;
+  }
+
+  if (!encoder.hasCardEncoding()) {
+    if (rhs >= objFunction.size())
+      return;
+    encoder.buildCardinality(solver, objFunction, rhs);
+  }
+  encoder.incUpdateCardinality(solver, objFunction, rhs, encodingAssumptions);
+  for (int i = 0; i < encodingAssumptions.size(); i++)
+    assumptions.push(encodingAssumptions[i]);
+}
+
+void Hybrid::newModel() {
+  nbSatisfiable++;
+  uint64_t newCost = computeCostModel(solver->model);
+  saveModel(solver->model);
+  printBound(newCost);
+
+  ubCost = newCost;
+  if (newCost > 0)
+    notifyUpperBound(solver, newCost - 1);
+}
+
+// Print Hybrid configuration.
+void Hybrid::print_Hybrid_configuration() {
+  printf("c |  Algorithm: %23s                                             "
+         "                      |\n",
+         "Hybrid MSU3/LinearSU");
+}
@@ -0,0 +1,90 @@
+/*!
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef Alg_Hybrid_h
+#define Alg_Hybrid_h
+
+#include "Alg_MSU3.h"
+
+namespace openwbo {
+
+//=================================================================================================
+// Core-guided and model-improving search on the same SAT solver. The MSU3
+// iterations raise the lower bound, the linear search iterations lower the
+// upper bound, and both constrain the same incremental totalizer. Each side
+// runs with a conflict budget per call, when a call runs out of it the budget
+// of that side is doubled and the other side takes over.
+class Hybrid : public MSU3 {
+
+public:
+  Hybrid(int verb = _VERBOSITY_MINIMAL_, int64_t budget = 10000)
+      : MSU3(verb) {
+    initialBudget = budget;
+    allActive = false;
+  }
+
+  StatusCode search(); // Hybrid search.
+
+  // Print solver configuration.
+  void printConfiguration() {
+
+    if(!print) return;
+
+    printf("c ==========================================[ Solver Settings "
+           "]============================================\n");
+    printf("c |                                                                "
+           "                                       |\n");
+
+    print_Hybrid_configuration();
+    print_Card_configuration(_CARD_TOTALIZER_);
+  }
+
+protected:
+  // Print Hybrid configuration.
+  void print_Hybrid_configuration();
+
+  StatusCode hybridSearch();
+
+  // Lower bound side: a core of the soft clauses (MSU3) or, once the
+  // totalizer counts all of them, a refutation of 'lbCost'.
+  lbool lowerBoundStep(int64_t budget);
+  // Upper bound side: a model cheaper than 'ubCost'.
+  lbool upperBoundStep(int64_t budget);
+
+  // Adds the soft clauses that are not in the totalizer yet.
+  void activateAll();
+  // Assumptions that bound the relaxed soft clauses by 'rhs'.
+  void boundAssumptions(int64_t rhs, vec<Lit> &assumptions);
+
+  // Saves the model of the last call and updates 'ubCost'.
+  void newModel();
+
+  int64_t initialBudget; // Conflicts of the first call of each side.
+  bool allActive;        // All the soft clauses are in the totalizer.
+  vec<Lit> encodingAssumptions;
+};
+} // namespace openwbo
+
+#endif
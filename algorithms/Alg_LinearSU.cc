@@ -80,6 +80,8 @@ StatusCode LinearSU::bmoSearch() {
     // NOTE: When preprocessing is enabled the SAT solver simplifies the
     // relaxation variables which leads to incorrect results.
     res = searchSATSolver(solver, dummy);
+    if (res == l_Undef)
+      return stoppedAnswer();
 
     if (res == l_True) {
       nbSatisfiable++;
@@ -214,6 +216,8 @@ StatusCode LinearSU::normalSearch() {
     // NOTE: When preprocessing is enabled the SAT solver simplifies the
     // relaxation variables which leads to incorrect results.
     res = searchSATSolver(solver, dummy);
+    if (res == l_Undef)
+      return stoppedAnswer();
 
     if (res == l_True) {
       nbSatisfiable++;
@@ -266,6 +270,7 @@ StatusCode LinearSU::normalSearch() {
         }
 
         ubCost = newCost;
+        notifyUpperBound(solver, newCost - 1);
       }
     } else {
       nbCores++;
@@ -352,7 +357,7 @@ Solver *LinearSU::rebuildSolver(uint64_t min_weight) {
 
   for (int i = 0; i < maxsat_formula->nCard(); i++) {
     Encoder *enc = new Encoder(_INCREMENTAL_NONE_, _CARD_MTOTALIZER_,
-                               _AMO_LADDER_, _PB_GTE_);
+                               maxsat_formula->getAMOEncoding(), _PB_GTE_);
 
     if (maxsat_formula->getCardinalityConstraint(i)->_rhs == 1) {
       enc->encodeAMO(S, maxsat_formula->getCardinalityConstraint(i)->_lits);
@@ -89,6 +89,8 @@ StatusCode MSU3::MSU3_iterative() {
     }
     counter++;
     res = searchSATSolver(solver, assumptions);
+    if (res == l_Undef)
+      return stoppedAnswer();
     if (res == l_True) {
       nbSatisfiable++;
       uint64_t newCost = computeCostModel(solver->model);
@@ -96,8 +98,12 @@ StatusCode MSU3::MSU3_iterative() {
       printBound(newCost);
 
       ubCost = newCost;
+      notifyUpperBound(solver, newCost);
 
       if (nbSatisfiable == 1) {
+        // The initial partial model only guides the first call; cores must
+        // be extracted over the soft clauses alone.
+        assumptions.clear();
         for (int i = 0; i < objFunction.size(); i++)
           assumptions.push(~objFunction[i]);
       } else {
@@ -268,7 +274,7 @@ Solver *MSU3::rebuildSolver() {
   // printf("c #Card: %d\n", maxsat_formula->nCard());
   for (int i = 0; i < maxsat_formula->nCard(); i++) {
     Encoder *enc = new Encoder(_INCREMENTAL_NONE_, _CARD_MTOTALIZER_,
-                               _AMO_LADDER_, _PB_GTE_);
+                               maxsat_formula->getAMOEncoding(), _PB_GTE_);
 
     if (maxsat_formula->getCardinalityConstraint(i)->_rhs == 1) {
       enc->encodeAMO(S, maxsat_formula->getCardinalityConstraint(i)->_lits);
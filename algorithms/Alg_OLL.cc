@@ -121,6 +121,8 @@ StatusCode OLL::unweighted() {
   for (;;) {
 
     res = searchSATSolver(solver, assumptions);
+    if (res == l_Undef)
+      return stoppedAnswer();
     if (res == l_True) {
       nbSatisfiable++;
       uint64_t newCost = computeCostModel(solver->model);
@@ -134,6 +136,7 @@ StatusCode OLL::unweighted() {
         printBound(newCost + off_set);
 
       ubCost = newCost;
+      notifyUpperBound(solver, newCost);
 
       if (nbSatisfiable == 1) {
         if (newCost == 0) {
@@ -319,6 +322,8 @@ StatusCode OLL::weighted() {
   for (;;) {
 
     res = searchSATSolver(solver, assumptions);
+    if (res == l_Undef)
+      return stoppedAnswer();
     if (res == l_True) {
       nbSatisfiable++;
       uint64_t newCost = computeCostModel(solver->model);
@@ -332,6 +337,7 @@ StatusCode OLL::weighted() {
         } else
           printBound(newCost + off_set);
         ubCost = newCost;
+        notifyUpperBound(solver, newCost);
       }
 
       if (nbSatisfiable == 1) {
@@ -825,7 +831,7 @@ Solver *OLL::rebuildSolver() {
   // printf("c #Card: %d\n", maxsat_formula->nCard());
   for (int i = 0; i < maxsat_formula->nCard(); i++) {
     Encoder *enc = new Encoder(_INCREMENTAL_NONE_, _CARD_MTOTALIZER_,
-                               _AMO_LADDER_, _PB_GTE_);
+                               maxsat_formula->getAMOEncoding(), _PB_GTE_);
 
     if (maxsat_formula->getCardinalityConstraint(i)->_rhs == 1) {
       enc->encodeAMO(S, maxsat_formula->getCardinalityConstraint(i)->_lits);
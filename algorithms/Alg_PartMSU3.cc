@@ -31,7 +31,9 @@
 #include <iostream>
 
 #include <algorithm>
+#include <atomic>
 #include <list>
+#include <thread>
 #include <unordered_map>
 
 #define NO_PAIR -1
@@ -504,6 +506,8 @@ StatusCode PartMSU3::PartMSU3_sequential() {
   for (;;) {
 
     res = searchSATSolver(solver, assumptions);
+    if (res == l_Undef)
+      return stoppedAnswer();
     if (res == l_True) {
       nbSatisfiable++;
       uint64_t newCost = computeCostModel(solver->model);
@@ -511,6 +515,7 @@ StatusCode PartMSU3::PartMSU3_sequential() {
         saveModel(solver->model);
         printBound(newCost);
         ubCost = newCost;
+        notifyUpperBound(solver, newCost);
       }
 
       if (merge_strategy == _PART_SEQUENTIAL_) {
@@ -700,8 +705,15 @@ StatusCode PartMSU3::PartMSU3_binary() {
   for (int i = 0; i < maxsat_formula->nSoft(); i++)
     coreMapping[getAssumptionLit(i)] = i;
 
+  if (nThreads > 1 && guide_tree.size() > 1 && !solveLeaves(guide_tree)) {
+    printAnswer(_UNSATISFIABLE_);
+    return _UNSATISFIABLE_;
+  }
+
   for (;;) {
     res = searchSATSolver(solver, assumptions);
+    if (res == l_Undef)
+      return stoppedAnswer();
     if (res == l_True) {
       nbSatisfiable++;
       uint64_t newCost = computeCostModel(solver->model);
@@ -709,18 +721,28 @@ StatusCode PartMSU3::PartMSU3_binary() {
         saveModel(solver->model);
         printBound(newCost);
         ubCost = newCost;
+        notifyUpperBound(solver, newCost);
       }
 
       if (nbSatisfiable == 1) {
         // assert(part_index == 0);
+        if (guide_tree.empty() || lbCost == ubCost) {
+          // No partition has soft clauses left to relax, or the lower bounds
+          // of the leaves already match the model
+          printAnswer(_OPTIMUM_);
+          return _OPTIMUM_;
+        }
         current_node = guide_tree.front();
         guide_tree.pop_front();
         for (int i = 0; i < current_node->getPartitions().size(); ++i) {
           int comm = current_node->getPartitions()[i];
           for (int j = 0; j < nPartitionSoft(comm); ++j) {
-            assumptions.push(~getAssumptionLit(communitySoft(comm)[j]));
+            if (!activeSoft[communitySoft(comm)[j]]) {
+              assumptions.push(~getAssumptionLit(communitySoft(comm)[j]));
+            }
           }
         }
+        addVector(assumptions, *(current_node->getEncodingAssumptions()));
       } else if (current_node->hasParent()) // no parent -> current_node is root
       {
         TreeNode *parent = current_node->getParent();
@@ -916,6 +938,150 @@ StatusCode PartMSU3::PartMSU3_binary() {
   }
 }
 
+/*_________________________________________________________________________________________________
+  |
+  |  solveLeaves : (leaves : deque<TreeNode *>&)  ->  [bool]
+  |
+  |  Description:
+  |
+  |    Runs MSU3 on the soft clauses of every leaf of the guide tree, in
+  |    parallel and each leaf with a SAT solver of its own. The leaves share no
+  |    soft clauses, so the sum of their lower bounds is a lower bound. The
+  |    relaxed soft clauses and the lower bound of every leaf are then encoded
+  |    on the main solver as the sequential algorithm would have done, and the
+  |    merging of the leaves continues sequentially from there.
+  |
+  |  Post-conditions:
+  |    * Returns false if the hard clauses are unsatisfiable.
+  |    * 'activeSoft', 'lbCost' and the encoders of the leaves are updated.
+  |
+  |________________________________________________________________________________________________@*/
+bool PartMSU3::solveLeaves(std::deque<TreeNode *> &leaves) {
+  std::vector<LeafResult> results(leaves.size());
+  std::atomic<int> next(0);
+  std::vector<std::thread> threads;
+  int n = std::min(nThreads, (int)leaves.size());
+
+  // Checkpoints are only saved by the main solver, the requests made while
+  // the leaves are solved wait for it.
+  CheckpointListener *listener = checkpointListener;
+  checkpointListener = NULL;
+  for (int t = 0; t < n; t++) {
+    threads.push_back(std::thread([&]() {
+      for (int i = next++; i < (int)leaves.size(); i = next++)
+        solveLeaf(leaves[i], results[i]);
+    }));
+  }
+  for (int t = 0; t < n; t++)
+    threads[t].join();
+  checkpointListener = listener;
+
+  vec<Lit> currentObjFunction;
+  for (int i = 0; i < (int)leaves.size(); i++) {
+    if (results[i].unsat)
+      return false;
+
+    TreeNode *leaf = leaves[i];
+    currentObjFunction.clear();
+    for (int soft : results[i].relaxed) {
+      activeSoft[soft] = true;
+      currentObjFunction.push(getRelaxationLit(soft));
+    }
+    leaf->incrementLowerBound(results[i].lb);
+    lbCost += results[i].lb;
+    nbCores += results[i].cores;
+
+    if (results[i].lb > 0 &&
+        results[i].lb != (int64_t)currentObjFunction.size()) {
+      leaf->getEncoder()->buildCardinality(solver, currentObjFunction,
+                                           results[i].lb);
+      leaf->getEncoder()->incUpdateCardinality(
+          solver, currentObjFunction, results[i].lb,
+          *(leaf->getEncodingAssumptions()));
+    }
+  }
+
+  if (verbosity > 0)
+    printf("c LB : %-12" PRIu64 " (%d leaves with %d threads)\n", lbCost,
+           (int)leaves.size(), n);
+
+  return true;
+}
+
+// MSU3 restricted to the soft clauses of a leaf, the other soft clauses are
+// not assumed. Runs in a thread of solveLeaves, so the calls go to
+// 'solveSATSolver()': the checkpoint listener and 'runningSolver' of
+// 'searchSATSolver()' belong to the solver of the merged partitions.
+void PartMSU3::solveLeaf(TreeNode *leaf, LeafResult &result) {
+  Solver *S = rebuildSolver();
+  applyDecisionHints(S);
+  seedBestPhase(S);
+  Encoder encoder(incremental_strategy, encoding);
+  vec<Lit> assumptions;
+  vec<Lit> encodingAssumptions;
+  vec<Lit> currentObjFunction;
+  vec<Lit> joinObjFunction;
+  vec<int> softs;
+  std::vector<bool> relaxed(maxsat_formula->nSoft(), false);
+
+  for (int i = 0; i < leaf->getPartitions().size(); ++i) {
+    int comm = leaf->getPartitions()[i];
+    for (int j = 0; j < nPartitionSoft(comm); ++j)
+      softs.push(communitySoft(comm)[j]);
+  }
+
+  result.lb = 0;
+  result.cores = 0;
+  result.unsat = false;
+  while (!stopped) {
+    assumptions.clear();
+    for (int i = 0; i < softs.size(); i++) {
+      if (!relaxed[softs[i]])
+        assumptions.push(~getAssumptionLit(softs[i]));
+    }
+    addVector(assumptions, encodingAssumptions);
+
+    lbool res = solveSATSolver(S, assumptions, false);
+    if (res != l_False)
+      break;
+    if (S->conflict.size() == 0) {
+      result.unsat = true;
+      break;
+    }
+
+    result.lb++;
+    result.cores++;
+    joinObjFunction.clear();
+    for (int i = 0; i < S->conflict.size(); i++) {
+      std::map<Lit, int>::iterator it = coreMapping.find(S->conflict[i]);
+      if (it != coreMapping.end()) {
+        relaxed[it->second] = true;
+        result.relaxed.push_back(it->second);
+        joinObjFunction.push(getRelaxationLit(it->second));
+      }
+    }
+    currentObjFunction.clear();
+    for (int soft : result.relaxed)
+      currentObjFunction.push(getRelaxationLit(soft));
+
+    if (!encoder.hasCardEncoding()) {
+      if (result.lb != currentObjFunction.size()) {
+        encoder.buildCardinality(S, currentObjFunction, result.lb);
+        encoder.incUpdateCardinality(S, currentObjFunction, result.lb,
+                                     encodingAssumptions);
+      }
+    } else {
+      if (joinObjFunction.size() > 0)
+        encoder.joinEncoding(S, joinObjFunction, result.lb);
+      encodingAssumptions.clear();
+      encoder.incUpdateCardinality(S, currentObjFunction, result.lb,
+                                   encodingAssumptions);
+    }
+  }
+
+  delete S;
+}
+
 StatusCode PartMSU3::search() {
   if (maxsat_formula->getProblemType() == _WEIGHTED_) {
     if(print) {
@@ -1023,7 +1189,7 @@ Solver *PartMSU3::rebuildSolver() {
   // printf("c #Card: %d\n", maxsat_formula->nCard());
   for (int i = 0; i < maxsat_formula->nCard(); i++) {
     Encoder *enc = new Encoder(_INCREMENTAL_NONE_, _CARD_MTOTALIZER_,
-                               _AMO_LADDER_, _PB_GTE_);
+                               maxsat_formula->getAMOEncoding(), _PB_GTE_);
 
     if (maxsat_formula->getCardinalityConstraint(i)->_rhs == 1) {
       enc->encodeAMO(S, maxsat_formula->getCardinalityConstraint(i)->_lits);
@@ -1105,6 +1271,11 @@ void PartMSU3::print_PartMSU3_configuration() {
            "                       |\n",
            "Resolution");
     break;
+  case GROUP_GRAPH:
+    printf("c |  Graph Type: %22s                                            "
+           "                       |\n",
+           "Soft groups");
+    break;
   }
 
   printf("c |  Number of partitions: %12d                                      "
@@ -40,6 +40,7 @@
 #include <deque>
 #include <map>
 #include <set>
+#include <vector>
 
 namespace openwbo {
 
@@ -98,6 +99,7 @@ public:
     graph_type = graph;
     incremental_strategy = _INCREMENTAL_ITERATIVE_;
     encoding = enc;
+    nThreads = 1;
   }
   virtual ~PartMSU3() {
     if (this->solver != NULL) {
@@ -129,7 +131,19 @@ public:
 
   int chooseAlgorithm();
 
+  // Number of threads that solve the leaves of the guide tree (binary
+  // merging only).
+  void setThreads(int n) { nThreads = n; }
+
 protected:
+  // Outcome of the MSU3 search on the soft clauses of a single leaf.
+  struct LeafResult {
+    std::vector<int> relaxed; // Soft clauses relaxed by the cores.
+    int64_t lb;
+    int cores;
+    bool unsat; // The hard clauses are unsatisfiable.
+  };
+
   // Print PartMSU3 configuration.
   void print_PartMSU3_configuration();
 
@@ -141,6 +155,9 @@ protected:
                               // single partition
   StatusCode PartMSU3_binary(); // MSU3 that uses a binary tree to guide the partition
                           // merging process
+  bool solveLeaves(deque<TreeNode *> &leaves); // Lower bounds of the leaves
+                                               // in parallel.
+  void solveLeaf(TreeNode *leaf, LeafResult &result);
 
   // Heuristics
   mpq_class *computeSparsity();
@@ -162,6 +179,8 @@ protected:
   int incremental_strategy;
   // Controls the cardinality encoding used by MSU3 algorithms.
   int encoding;
+  // Threads used by solveLeaves.
+  int nThreads;
 
   // Literals to be used in the constraint that excludes models.
   vec<Lit> objFunction;
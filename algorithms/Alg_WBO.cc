@@ -117,7 +117,7 @@ Solver *WBO::rebuildWeightSolver(int strategy) {
   // printf("c #Card: %d\n", maxsat_formula->nCard());
   for (int i = 0; i < maxsat_formula->nCard(); i++) {
     Encoder *enc = new Encoder(_INCREMENTAL_NONE_, _CARD_MTOTALIZER_,
-                               _AMO_LADDER_, _PB_GTE_);
+                               maxsat_formula->getAMOEncoding(), _PB_GTE_);
 
     if (maxsat_formula->getCardinalityConstraint(i)->_rhs == 1) {
       enc->encodeAMO(S, maxsat_formula->getCardinalityConstraint(i)->_lits);
@@ -196,7 +196,7 @@ Solver *WBO::rebuildSolver() {
   // printf("c #Card: %d\n", maxsat_formula->nCard());
   for (int i = 0; i < maxsat_formula->nCard(); i++) {
     Encoder *enc = new Encoder(_INCREMENTAL_NONE_, _CARD_MTOTALIZER_,
-                               _AMO_LADDER_, _PB_GTE_);
+                               maxsat_formula->getAMOEncoding(), _PB_GTE_);
 
     if (maxsat_formula->getCardinalityConstraint(i)->_rhs == 1) {
       enc->encodeAMO(S, maxsat_formula->getCardinalityConstraint(i)->_lits);
@@ -254,7 +254,7 @@ Solver *WBO::rebuildHardSolver() {
   // printf("c #Card: %d\n", maxsat_formula->nCard());
   for (int i = 0; i < maxsat_formula->nCard(); i++) {
     Encoder *enc = new Encoder(_INCREMENTAL_NONE_, _CARD_MTOTALIZER_,
-                               _AMO_LADDER_, _PB_GTE_);
+                               maxsat_formula->getAMOEncoding(), _PB_GTE_);
 
     if (maxsat_formula->getCardinalityConstraint(i)->_rhs == 1) {
       enc->encodeAMO(S, maxsat_formula->getCardinalityConstraint(i)->_lits);
@@ -864,6 +864,8 @@ StatusCode WBO::weightSearch() {
   for (;;) {
 
     lbool res = searchSATSolver(solver, assumptions);
+    if (res == l_Undef)
+      return stoppedAnswer();
 
     if (res == l_False) {
       nbCores++;
@@ -943,6 +945,8 @@ StatusCode WBO::normalSearch() {
   for (;;) {
 
     lbool res = searchSATSolver(solver, assumptions);
+    if (res == l_Undef)
+      return stoppedAnswer();
 
     if (res == l_False) {
       nbCores++;
@@ -0,0 +1,67 @@
+/*
+ * bimander.hh
+ *
+ * bimander encoding of at-most-one (V.-H. Nguyen and S. T. Mai, "A new
+ * method to encode the at-most-one constraint into SAT", SoICT 2015): the
+ * variables are split in groups with a pairwise AMO each, and every variable
+ * implies the binary code of its group as in the bitwise encoding
+ */
+
+#ifndef BIMANDER_HH_
+#define BIMANDER_HH_
+
+#include <cmath>
+#include "common.hh"
+#include "pairwise.hh"
+
+//
+//=============================================================================
+inline void bimander_encode_atmost1(
+	int& top_id,
+	ClauseSet& clset,
+	vector<int>& vars,
+	size_t group = 2
+)
+{
+	if (vars.size() <= group + 1) {
+		pairwise_encode_atmost1(clset, vars);
+		return;
+	}
+
+	size_t ngroups = (vars.size() + group - 1) / group;
+	size_t naux = ceil(log(1.0 * ngroups) / log(2.0));
+
+	vector<int> bits, members, cl(2);
+
+	for (size_t j = 0; j < naux; ++j)
+		bits.push_back(++top_id);
+
+	for (size_t g = 0; g < ngroups; ++g) {
+		members.clear();
+		for (size_t i = g * group; i < (g + 1) * group && i < vars.size(); ++i) {
+			members.push_back(vars[i]);
+
+			for (size_t j = 0; j < naux; ++j) {
+				cl[0] = -vars[i];
+				cl[1] = ((g >> j) & 1) ? bits[j] : -bits[j];
+				clset.create_clause(cl);
+			}
+		}
+
+		pairwise_encode_atmost1(clset, members);
+	}
+}
+
+//
+//=============================================================================
+inline void bimander_encode_equals1(
+	int& top_id,
+	ClauseSet& clset,
+	vector<int>& vars
+)
+{
+	common_encode_atleast1(         clset, vars);
+	bimander_encode_atmost1(top_id, clset, vars);
+}
+
+#endif // BIMANDER_HH_
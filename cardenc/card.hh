@@ -8,11 +8,17 @@
 #ifndef CARD_HH_
 #define CARD_HH_
 
+#include <map>
+#include <mutex>
+#include <cstdio>
+#include "bimander.hh"
 #include "bitwise.hh"
 #include "clset.hh"
+#include "commander.hh"
 #include "ladder.hh"
 #include "mto.hh"
 #include "pairwise.hh"
+#include "product.hh"
 #include "seqcounter.hh"
 #include "sortcard.hh"
 
@@ -27,9 +33,153 @@ enum EncType {
 	enc_ladd  = 5,
 	enc_tot   = 6,
 	enc_mtot  = 7,
-	enc_kmtot = 8
+	enc_kmtot = 8,
+	enc_prod  = 9,  // product, only for bound == 1
+	enc_cmdr  = 10, // commander, only for bound == 1
+	enc_bimd  = 11, // bimander, only for bound == 1
+	enc_adapt = 12, // chosen per constraint by size, only for bound == 1
+	enc_native = 13 // propagated by the SAT solver, only for bound == 1
 };
 
+static inline void _encode_atmost(ClauseSet& dest, vector<int>& lhs, int rhs, int& top, int enc);
+
+// adaptive at-most-one: for every constraint size the candidate encodings are
+// generated once on a scratch clause set and the cheapest one is used from
+// then on. The cost counts clauses, aux variables (more search space) and the
+// propagation measured on the scratch clauses: the clauses visited to
+// propagate an input set to true, and the inputs that are not propagated. The
+// weights are fixed, the choice does not depend on timings of the host
+//=============================================================================
+struct AdaptiveAMO {
+	std::mutex lock;
+	map<size_t, int> best;  // constraint size -> encoding
+	vector<size_t> mix;     // number of constraints encoded with each encoding
+
+	AdaptiveAMO() : mix(enc_adapt, 0) {}
+};
+
+static inline AdaptiveAMO& _adaptive_amo()
+{
+	static AdaptiveAMO state;
+	return state;
+}
+
+static inline const char *_enc_name(int enc)
+{
+	static const char *names[] = {
+		"pairwise", "seqcounter", "sortnet", "cardnet", "bitwise", "ladder",
+		"totalizer", "mtotalizer", "kmtotalizer", "product", "commander", "bimander"
+	};
+	return enc >= 0 && enc < enc_adapt ? names[enc] : "adaptive";
+}
+
+// unit propagation on an at-most-one encoding over the variables 1..n: every
+// input is set to true in turn and propagated, 'visits' sums the clauses
+// looked at and 'missed' the other inputs that are not set to false
+static inline void _amo_propagation(ClauseSet& cls, size_t n, int top, size_t& visits, size_t& missed)
+{
+	vector<vector<size_t> > occurs(2 * (top + 1));  // clauses of each literal
+	for (size_t c = 0; c < cls.size(); ++c)
+		for (size_t i = 0; i < cls[c].size(); ++i)
+			occurs[2 * abs(cls[c][i]) + (cls[c][i] < 0)].push_back(c);
+
+	vector<int> value(top + 1);
+	vector<int> trail;
+	visits = missed = 0;
+	for (size_t x = 1; x <= n; ++x) {
+		fill(value.begin(), value.end(), 0);
+		trail.assign(1, x);
+		value[x] = 1;
+		for (size_t head = 0; head < trail.size(); ++head) {
+			// clauses where the opposite literal of the assignment occurs
+			int lit = -trail[head];
+			vector<size_t>& cs = occurs[2 * abs(lit) + (lit < 0)];
+			for (size_t k = 0; k < cs.size(); ++k) {
+				vector<int>& cl = cls[cs[k]];
+				int unassigned = 0, free_lit = 0;
+				bool sat = false;
+				visits++;
+				for (size_t i = 0; i < cl.size() && !sat; ++i) {
+					int v = value[abs(cl[i])];
+					if (v == 0) {
+						unassigned++;
+						free_lit = cl[i];
+					} else
+						sat = (v > 0) == (cl[i] > 0);
+				}
+				if (!sat && unassigned == 1) {
+					value[abs(free_lit)] = free_lit > 0 ? 1 : -1;
+					trail.push_back(free_lit);
+				}
+			}
+		}
+		for (size_t y = 1; y <= n; ++y)
+			if (y != x && value[y] >= 0)
+				missed++;
+	}
+}
+
+static inline double _amo_cost(int enc, size_t n)
+{
+	vector<int> vars;
+	for (size_t i = 1; i <= n; ++i)
+		vars.push_back(i);
+
+	ClauseSet scratch;
+	int top = n;
+	_encode_atmost(scratch, vars, 1, top, enc);
+
+	size_t visits, missed;
+	_amo_propagation(scratch, n, top, visits, missed);
+
+	// an input that is not propagated costs as much as the clauses that
+	// would propagate it
+	return scratch.size() + 2.0 * (top - n) + (double)visits / n + (double)missed * n / 2;
+}
+
+static inline int adaptive_select_atmost1(size_t n)
+{
+	static const int candidates[] = { enc_exp, enc_seqc, enc_bitw, enc_ladd, enc_prod, enc_cmdr, enc_bimd };
+	AdaptiveAMO& state = _adaptive_amo();
+	std::lock_guard<std::mutex> guard(state.lock);
+
+	map<size_t, int>::iterator it = state.best.find(n);
+	if (it == state.best.end()) {
+		int enc = enc_exp;
+		double cost = -1;
+		for (size_t i = 0; i < sizeof(candidates) / sizeof(int); ++i) {
+			// pairwise is quadratic, do not even try it on large sets
+			if (candidates[i] == enc_exp && n > 32)
+				continue;
+
+			double c = _amo_cost(candidates[i], n);
+			if (cost < 0 || c < cost) {
+				cost = c;
+				enc = candidates[i];
+			}
+		}
+		it = state.best.insert(make_pair(n, enc)).first;
+	}
+
+	state.mix[it->second]++;
+	return it->second;
+}
+
+// prints how many constraints were given to each encoding since the last report
+static inline void adaptive_report()
+{
+	AdaptiveAMO& state = _adaptive_amo();
+	std::lock_guard<std::mutex> guard(state.lock);
+
+	printf("c AMO encodings chosen:");
+	for (int enc = 0; enc < enc_adapt; ++enc) {
+		if (state.mix[enc])
+			printf(" %s=%zu", _enc_name(enc), state.mix[enc]);
+		state.mix[enc] = 0;
+	}
+	printf("\n");
+}
+
 //
 //=============================================================================
 static inline void _encode_atmost(
@@ -40,7 +190,13 @@ static inline void _encode_atmost(
 	int enc
 )
 {
-	if (enc == enc_cardn)
+	if (enc == enc_adapt)
+		_encode_atmost(dest, lhs, rhs, top, rhs == 1 ? adaptive_select_atmost1(lhs.size()) : enc_seqc);
+	else if (enc == enc_native)
+		// the caller hands native constraints to the solver, only a
+		// clause set was asked for here
+		_encode_atmost(dest, lhs, rhs, top, rhs == 1 ? enc_ladd : enc_seqc);
+	else if (enc == enc_cardn)
 		cardn_encode_atmostN(top, dest, lhs, rhs);
 	else if (enc == enc_sortn)
 		sortn_encode_atmostN(top, dest, lhs, rhs);
@@ -59,6 +215,12 @@ static inline void _encode_atmost(
 			pairwise_encode_atmost1(dest, lhs);
 		else if (enc == enc_ladd)
 			ladder_encode_atmost1(top, dest, lhs);
+		else if (enc == enc_prod)
+			product_encode_atmost1(top, dest, lhs);
+		else if (enc == enc_cmdr)
+			commander_encode_atmost1(top, dest, lhs);
+		else if (enc == enc_bimd)
+			bimander_encode_atmost1(top, dest, lhs);
 	}
 }
 
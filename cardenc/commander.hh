@@ -0,0 +1,63 @@
+/*
+ * commander.hh
+ *
+ * commander encoding of at-most-one (W. Klieber and G. Kwon, "Efficient CNF
+ * encoding for selecting 1 from N objects", CFV 2007): the variables are
+ * split in groups of 3 with a pairwise AMO each, every variable implies the
+ * commander of its group and at most one commander is true (recursively)
+ */
+
+#ifndef COMMANDER_HH_
+#define COMMANDER_HH_
+
+#include "common.hh"
+#include "pairwise.hh"
+
+//
+//=============================================================================
+inline void commander_encode_atmost1(
+	int& top_id,
+	ClauseSet& clset,
+	vector<int>& vars,
+	size_t group = 3
+)
+{
+	if (vars.size() <= group + 1) {
+		pairwise_encode_atmost1(clset, vars);
+		return;
+	}
+
+	vector<int> commanders, members, cl(2);
+
+	for (size_t i = 0; i < vars.size(); i += group) {
+		int c = ++top_id;
+		commanders.push_back(c);
+
+		members.clear();
+		for (size_t j = i; j < i + group && j < vars.size(); ++j) {
+			members.push_back(vars[j]);
+
+			cl[0] = -vars[j];
+			cl[1] =  c;
+			clset.create_clause(cl);
+		}
+
+		pairwise_encode_atmost1(clset, members);
+	}
+
+	commander_encode_atmost1(top_id, clset, commanders, group);
+}
+
+//
+//=============================================================================
+inline void commander_encode_equals1(
+	int& top_id,
+	ClauseSet& clset,
+	vector<int>& vars
+)
+{
+	common_encode_atleast1(          clset, vars);
+	commander_encode_atmost1(top_id, clset, vars);
+}
+
+#endif // COMMANDER_HH_
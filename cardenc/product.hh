@@ -0,0 +1,69 @@
+/*
+ * product.hh
+ *
+ * product encoding of at-most-one (J. Chen, "A new SAT encoding of the
+ * at-most-one constraint", ModRef 2010): the variables are laid out in a
+ * p x q grid and each one implies its row and its column variable, so 2n
+ * binary clauses plus two recursive AMOs over about 2*sqrt(n) variables
+ */
+
+#ifndef PRODUCT_HH_
+#define PRODUCT_HH_
+
+#include <cmath>
+#include "common.hh"
+#include "pairwise.hh"
+
+//
+//=============================================================================
+inline void product_encode_atmost1(
+	int& top_id,
+	ClauseSet& clset,
+	vector<int>& vars
+)
+{
+	// below this size pairwise is smaller
+	if (vars.size() <= 4) {
+		pairwise_encode_atmost1(clset, vars);
+		return;
+	}
+
+	size_t p = ceil(sqrt(1.0 * vars.size()));
+	size_t q = (vars.size() + p - 1) / p;
+
+	vector<int> rows, cols;
+
+	for (size_t j = 0; j < p; ++j)
+		cols.push_back(++top_id);
+
+	for (size_t j = 0; j < q; ++j)
+		rows.push_back(++top_id);
+
+	vector<int> cl(2);
+
+	for (size_t i = 0; i < vars.size(); ++i) {
+		cl[0] = -vars[i];
+		cl[1] =  rows[i / p];
+		clset.create_clause(cl);
+
+		cl[1] =  cols[i % p];
+		clset.create_clause(cl);
+	}
+
+	product_encode_atmost1(top_id, clset, rows);
+	product_encode_atmost1(top_id, clset, cols);
+}
+
+//
+//=============================================================================
+inline void product_encode_equals1(
+	int& top_id,
+	ClauseSet& clset,
+	vector<int>& vars
+)
+{
+	common_encode_atleast1(        clset, vars);
+	product_encode_atmost1(top_id, clset, vars);
+}
+
+#endif // PRODUCT_HH_
@@ -0,0 +1,225 @@
+/root/repo/Encoder.o /root/repo/Encoder.or /root/repo/Encoder.od /root/repo/Encoder.op: /root/repo/Encoder.cc /root/repo/Encoder.h \
+ /root/repo/solvers/glucose4.1/core/Solver.h \
+ /root/repo/solvers/glucose4.1/mtl/Heap.h \
+ /root/repo/solvers/glucose4.1/mtl/Vec.h \
+ /root/repo/solvers/glucose4.1/mtl/IntTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/XAlloc.h \
+ /root/repo/solvers/glucose4.1/mtl/Alg.h \
+ /root/repo/solvers/glucose4.1/utils/Options.h \
+ /root/repo/solvers/glucose4.1/utils/ParseUtils.h \
+ /root/repo/solvers/glucose4.1/core/SolverTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/Map.h \
+ /root/repo/solvers/glucose4.1/mtl/Alloc.h \
+ /root/repo/solvers/glucose4.1/core/BoundedQueue.h \
+ /root/repo/solvers/glucose4.1/core/Constants.h \
+ /root/repo/solvers/glucose4.1/mtl/Clone.h \
+ /root/repo/solvers/glucose4.1/core/SolverStats.h /root/repo/MaxTypes.h \
+ /root/repo/SATSolver.h /root/repo/encodings/Enc_CNetworks.h \
+ /root/repo/encodings/Encodings.h /root/repo/encodings/../MaxTypes.h \
+ /root/repo/encodings/../SATSolver.h /root/repo/encodings/Enc_GTE.h \
+ /root/repo/encodings/Enc_Ladder.h /root/repo/encodings/Enc_MTotalizer.h \
+ /root/repo/encodings/Enc_SWC.h /root/repo/encodings/Enc_Totalizer.h \
+ /root/repo/encodings/Enc_Adder.h
+/root/repo/Main.o /root/repo/Main.or /root/repo/Main.od /root/repo/Main.op: /root/repo/Main.cc /root/repo/solvers/glucose4.1/utils/Options.h \
+ /root/repo/solvers/glucose4.1/mtl/IntTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/Vec.h \
+ /root/repo/solvers/glucose4.1/mtl/XAlloc.h \
+ /root/repo/solvers/glucose4.1/utils/ParseUtils.h \
+ /root/repo/solvers/glucose4.1/utils/System.h \
+ /root/repo/MAPFEncoder/MAPFtoMaxSAT.hh \
+ /root/repo/MAPFEncoder/../cardenc/clset.hh \
+ /root/repo/MAPFEncoder/../cardenc/card.hh \
+ /root/repo/MAPFEncoder/../cardenc/bimander.hh \
+ /root/repo/MAPFEncoder/../cardenc/common.hh \
+ /root/repo/MAPFEncoder/../cardenc/clset.hh \
+ /root/repo/MAPFEncoder/../cardenc/pairwise.hh \
+ /root/repo/MAPFEncoder/../cardenc/bitwise.hh \
+ /root/repo/MAPFEncoder/../cardenc/commander.hh \
+ /root/repo/MAPFEncoder/../cardenc/ladder.hh \
+ /root/repo/MAPFEncoder/../cardenc/mto.hh \
+ /root/repo/MAPFEncoder/../cardenc/ptypes.hh \
+ /root/repo/MAPFEncoder/../cardenc/utils.hh \
+ /root/repo/MAPFEncoder/../cardenc/product.hh \
+ /root/repo/MAPFEncoder/../cardenc/seqcounter.hh \
+ /root/repo/MAPFEncoder/../cardenc/sortcard.hh \
+ /root/repo/MAPFEncoder/../MaxSAT.h \
+ /root/repo/solvers/glucose4.1/simp/SimpSolver.h \
+ /root/repo/solvers/glucose4.1/mtl/Queue.h \
+ /root/repo/solvers/glucose4.1/core/Solver.h \
+ /root/repo/solvers/glucose4.1/mtl/Heap.h \
+ /root/repo/solvers/glucose4.1/mtl/Alg.h \
+ /root/repo/solvers/glucose4.1/core/SolverTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/Map.h \
+ /root/repo/solvers/glucose4.1/mtl/Alloc.h \
+ /root/repo/solvers/glucose4.1/core/BoundedQueue.h \
+ /root/repo/solvers/glucose4.1/core/Constants.h \
+ /root/repo/solvers/glucose4.1/mtl/Clone.h \
+ /root/repo/solvers/glucose4.1/core/SolverStats.h \
+ /root/repo/MAPFEncoder/../MaxSATFormula.h \
+ /root/repo/MAPFEncoder/../FormulaPB.h \
+ /root/repo/MAPFEncoder/../MaxTypes.h \
+ /root/repo/MAPFEncoder/../SATSolver.h \
+ /root/repo/MAPFEncoder/../MaxTypes.h \
+ /root/repo/MAPFEncoder/../MaxSATFormula.h \
+ /root/repo/MAPFEncoder/MAPFLNS.hh /root/repo/MAPFEncoder/MAPFtoMaxSAT.hh \
+ /root/repo/MAPFEncoder/MAPFRollingHorizon.hh \
+ /root/repo/MAPFEncoder/MAPFCheckpoint.hh /root/repo/MaxSAT.h \
+ /root/repo/MaxTypes.h /root/repo/algorithms/Alg_LinearSU.h \
+ /root/repo/algorithms/../Encoder.h /root/repo/algorithms/../MaxTypes.h \
+ /root/repo/algorithms/../SATSolver.h \
+ /root/repo/algorithms/../encodings/Enc_CNetworks.h \
+ /root/repo/algorithms/../encodings/Encodings.h \
+ /root/repo/algorithms/../encodings/../MaxTypes.h \
+ /root/repo/algorithms/../encodings/../SATSolver.h \
+ /root/repo/algorithms/../encodings/Enc_GTE.h \
+ /root/repo/algorithms/../encodings/Enc_Ladder.h \
+ /root/repo/algorithms/../encodings/Enc_MTotalizer.h \
+ /root/repo/algorithms/../encodings/Enc_SWC.h \
+ /root/repo/algorithms/../encodings/Enc_Totalizer.h \
+ /root/repo/algorithms/../encodings/Enc_Adder.h \
+ /root/repo/algorithms/../MaxSAT.h /root/repo/algorithms/Alg_PartMSU3.h \
+ /root/repo/algorithms/../MaxSAT_Partition.h \
+ /root/repo/algorithms/../MaxSAT.h /root/repo/algorithms/../graph/Graph.h \
+ /root/repo/algorithms/../graph/Graph_Communities.h \
+ /root/repo/algorithms/../graph/Graph.h /root/repo/algorithms/Alg_MSU3.h \
+ /root/repo/algorithms/Alg_OLL.h /root/repo/algorithms/Alg_WBO.h \
+ /root/repo/algorithms/../MaxTypes.h /root/repo/algorithms/Alg_Hybrid.h \
+ /root/repo/algorithms/Alg_MSU3.h
+/root/repo/MaxSAT.o /root/repo/MaxSAT.or /root/repo/MaxSAT.od /root/repo/MaxSAT.op: /root/repo/MaxSAT.cc /root/repo/MaxSAT.h \
+ /root/repo/solvers/glucose4.1/simp/SimpSolver.h \
+ /root/repo/solvers/glucose4.1/mtl/Queue.h \
+ /root/repo/solvers/glucose4.1/mtl/Vec.h \
+ /root/repo/solvers/glucose4.1/mtl/IntTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/XAlloc.h \
+ /root/repo/solvers/glucose4.1/core/Solver.h \
+ /root/repo/solvers/glucose4.1/mtl/Heap.h \
+ /root/repo/solvers/glucose4.1/mtl/Alg.h \
+ /root/repo/solvers/glucose4.1/utils/Options.h \
+ /root/repo/solvers/glucose4.1/utils/ParseUtils.h \
+ /root/repo/solvers/glucose4.1/core/SolverTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/Map.h \
+ /root/repo/solvers/glucose4.1/mtl/Alloc.h \
+ /root/repo/solvers/glucose4.1/core/BoundedQueue.h \
+ /root/repo/solvers/glucose4.1/core/Constants.h \
+ /root/repo/solvers/glucose4.1/mtl/Clone.h \
+ /root/repo/solvers/glucose4.1/core/SolverStats.h \
+ /root/repo/MaxSATFormula.h /root/repo/FormulaPB.h /root/repo/MaxTypes.h \
+ /root/repo/SATSolver.h /root/repo/solvers/glucose4.1/utils/System.h
+/root/repo/MaxSATFormula.o /root/repo/MaxSATFormula.or /root/repo/MaxSATFormula.od /root/repo/MaxSATFormula.op: /root/repo/MaxSATFormula.cc /root/repo/MaxSATFormula.h \
+ /root/repo/solvers/glucose4.1/core/Solver.h \
+ /root/repo/solvers/glucose4.1/mtl/Heap.h \
+ /root/repo/solvers/glucose4.1/mtl/Vec.h \
+ /root/repo/solvers/glucose4.1/mtl/IntTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/XAlloc.h \
+ /root/repo/solvers/glucose4.1/mtl/Alg.h \
+ /root/repo/solvers/glucose4.1/utils/Options.h \
+ /root/repo/solvers/glucose4.1/utils/ParseUtils.h \
+ /root/repo/solvers/glucose4.1/core/SolverTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/Map.h \
+ /root/repo/solvers/glucose4.1/mtl/Alloc.h \
+ /root/repo/solvers/glucose4.1/core/BoundedQueue.h \
+ /root/repo/solvers/glucose4.1/core/Constants.h \
+ /root/repo/solvers/glucose4.1/mtl/Clone.h \
+ /root/repo/solvers/glucose4.1/core/SolverStats.h /root/repo/FormulaPB.h \
+ /root/repo/MaxTypes.h
+/root/repo/MaxSAT_Partition.o /root/repo/MaxSAT_Partition.or /root/repo/MaxSAT_Partition.od /root/repo/MaxSAT_Partition.op: /root/repo/MaxSAT_Partition.cc \
+ /root/repo/solvers/glucose4.1/core/SolverTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/IntTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/Alg.h \
+ /root/repo/solvers/glucose4.1/mtl/Vec.h \
+ /root/repo/solvers/glucose4.1/mtl/XAlloc.h \
+ /root/repo/solvers/glucose4.1/mtl/Map.h \
+ /root/repo/solvers/glucose4.1/mtl/Alloc.h /root/repo/MaxSAT_Partition.h \
+ /root/repo/MaxSAT.h /root/repo/solvers/glucose4.1/simp/SimpSolver.h \
+ /root/repo/solvers/glucose4.1/mtl/Queue.h \
+ /root/repo/solvers/glucose4.1/core/Solver.h \
+ /root/repo/solvers/glucose4.1/mtl/Heap.h \
+ /root/repo/solvers/glucose4.1/utils/Options.h \
+ /root/repo/solvers/glucose4.1/utils/ParseUtils.h \
+ /root/repo/solvers/glucose4.1/core/BoundedQueue.h \
+ /root/repo/solvers/glucose4.1/core/Constants.h \
+ /root/repo/solvers/glucose4.1/mtl/Clone.h \
+ /root/repo/solvers/glucose4.1/core/SolverStats.h \
+ /root/repo/MaxSATFormula.h /root/repo/FormulaPB.h /root/repo/MaxTypes.h \
+ /root/repo/SATSolver.h /root/repo/solvers/glucose4.1/utils/System.h \
+ /root/repo/graph/Graph.h /root/repo/graph/Graph_Communities.h \
+ /root/repo/graph/Graph.h
+/root/repo/ParserPB.o /root/repo/ParserPB.or /root/repo/ParserPB.od /root/repo/ParserPB.op: /root/repo/ParserPB.cc /root/repo/ParserPB.h \
+ /root/repo/MaxSATFormula.h /root/repo/solvers/glucose4.1/core/Solver.h \
+ /root/repo/solvers/glucose4.1/mtl/Heap.h \
+ /root/repo/solvers/glucose4.1/mtl/Vec.h \
+ /root/repo/solvers/glucose4.1/mtl/IntTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/XAlloc.h \
+ /root/repo/solvers/glucose4.1/mtl/Alg.h \
+ /root/repo/solvers/glucose4.1/utils/Options.h \
+ /root/repo/solvers/glucose4.1/utils/ParseUtils.h \
+ /root/repo/solvers/glucose4.1/core/SolverTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/Map.h \
+ /root/repo/solvers/glucose4.1/mtl/Alloc.h \
+ /root/repo/solvers/glucose4.1/core/BoundedQueue.h \
+ /root/repo/solvers/glucose4.1/core/Constants.h \
+ /root/repo/solvers/glucose4.1/mtl/Clone.h \
+ /root/repo/solvers/glucose4.1/core/SolverStats.h /root/repo/FormulaPB.h \
+ /root/repo/MaxTypes.h
+/root/repo/SATSolver.o /root/repo/SATSolver.or /root/repo/SATSolver.od /root/repo/SATSolver.op: /root/repo/SATSolver.cc /root/repo/SATSolver.h \
+ /root/repo/solvers/glucose4.1/core/SolverTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/IntTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/Alg.h \
+ /root/repo/solvers/glucose4.1/mtl/Vec.h \
+ /root/repo/solvers/glucose4.1/mtl/XAlloc.h \
+ /root/repo/solvers/glucose4.1/mtl/Map.h \
+ /root/repo/solvers/glucose4.1/mtl/Alloc.h /root/repo/MaxTypes.h \
+ /root/repo/satsolvers/Sat_Glucose41.h \
+ /root/repo/solvers/glucose4.1/simp/SimpSolver.h \
+ /root/repo/solvers/glucose4.1/mtl/Queue.h \
+ /root/repo/solvers/glucose4.1/core/Solver.h \
+ /root/repo/solvers/glucose4.1/mtl/Heap.h \
+ /root/repo/solvers/glucose4.1/utils/Options.h \
+ /root/repo/solvers/glucose4.1/utils/ParseUtils.h \
+ /root/repo/solvers/glucose4.1/core/BoundedQueue.h \
+ /root/repo/solvers/glucose4.1/core/Constants.h \
+ /root/repo/solvers/glucose4.1/mtl/Clone.h \
+ /root/repo/solvers/glucose4.1/core/SolverStats.h \
+ /root/repo/satsolvers/../SATSolver.h /root/repo/satsolvers/Sat_IPASIR.h \
+ /root/repo/satsolvers/IPASIR.h
+/home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/Solver.o /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/Solver.or /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/Solver.od /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/Solver.op: \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/Solver.cc \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/../mtl/Sort.h \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/../mtl/Vec.h \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/../mtl/IntTypes.h \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/../mtl/XAlloc.h \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/../core/Solver.h \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/../mtl/Heap.h \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/../mtl/Alg.h \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/../utils/Options.h \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/../utils/ParseUtils.h \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/../core/SolverTypes.h \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/../mtl/Map.h \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/../mtl/Alloc.h
+/home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/Main.o /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/Main.or /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/Main.od /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/Main.op: \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/Main.cc \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/../utils/System.h \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/../mtl/IntTypes.h \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/../utils/ParseUtils.h \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/../utils/Options.h \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/../mtl/Vec.h \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/../mtl/XAlloc.h \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/../core/Dimacs.h \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/../core/SolverTypes.h \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/../mtl/Alg.h \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/../mtl/Map.h \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/../mtl/Alloc.h \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/../core/Solver.h \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/core/../mtl/Heap.h
+/home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/utils/System.o /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/utils/System.or /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/utils/System.od /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/utils/System.op: \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/utils/System.cc \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/utils/../utils/System.h \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/utils/../mtl/IntTypes.h
+/home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/utils/Options.o /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/utils/Options.or /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/utils/Options.od /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/utils/Options.op: \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/utils/Options.cc \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/utils/../mtl/Sort.h \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/utils/../mtl/Vec.h \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/utils/../mtl/IntTypes.h \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/utils/../mtl/XAlloc.h \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/utils/../utils/Options.h \
+ /home/rasin/griveInf/investigacion/maxsatSolvers/open-wbo-github/solvers/minisat2.2/utils/../utils/ParseUtils.h
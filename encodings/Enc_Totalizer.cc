@@ -29,76 +29,121 @@
 
 using namespace openwbo;
 
-void Totalizer::incremental(Solver *S, int64_t rhs) {
+/*_________________________________________________________________________________________________
+  |
+  |  Iterative totalizer
+  |
+  |  Description:
+  |
+  |    The totalizer is kept as a tree where each node only has the outputs
+  |    that are needed for the current rhs, i.e. min(rhs+1, #inputs). When the
+  |    rhs is increased, the missing outputs (and the clauses that define them)
+  |    are added bottom-up. Joining new literals or another totalizer adds a
+  |    new root on top of the existing trees, which are reused as they are.
+  |
+  |  For further details see:
+  |    * Antonio Morgado, Alexey Ignatiev, Joao Marques-Silva: MSCG: Robust
+  |      Core-Guided MaxSAT Solving. JSAT 9: 129-134 (2014)
+  |
+  |________________________________________________________________________________________________@*/
+int Totalizer::newLeaf(Lit l) {
+  tree.push();
+  TotNode &leaf = tree.last();
+  leaf.outputs.push(l);
+  leaf.inputs = 1;
+  leaf.left = -1;
+  leaf.right = -1;
+  return tree.size() - 1;
+}
 
-  for (int z = 0; z < totalizerIterative_rhs.size(); z++) {
-
-    // We only need to count the sums up to k.
-    for (int i = 0; i <= totalizerIterative_left[z].size(); i++) {
-      for (int j = 0; j <= totalizerIterative_right[z].size(); j++) {
-
-        if (i == 0 && j == 0) {
-          continue;
-        }
-
-        if (i + j > rhs + 1 || i + j <= totalizerIterative_rhs[z] + 1) {
-          continue;
-        }
-
-        if (i == 0) {
-          addBinaryClause(S, ~(totalizerIterative_right[z])[j - 1],
-                          (totalizerIterative_output[z])[j - 1], blocking);
-          n_clauses++;
-        } else if (j == 0) {
-          addBinaryClause(S, ~(totalizerIterative_left[z])[i - 1],
-                          (totalizerIterative_output[z])[i - 1], blocking);
-          n_clauses++;
-        } else {
-          addTernaryClause(S, ~(totalizerIterative_left[z])[i - 1],
-                           ~(totalizerIterative_right[z])[j - 1],
-                           (totalizerIterative_output[z])[i + j - 1], blocking);
-          n_clauses++;
-        }
-      }
-    }
-    totalizerIterative_rhs[z] = rhs;
-  }
+int Totalizer::newNode(Solver *S, int left, int right, int64_t rhs) {
+  increase(S, left, rhs);
+  increase(S, right, rhs);
+
+  tree.push();
+  TotNode &node = tree.last();
+  node.inputs = tree[left].inputs + tree[right].inputs;
+  node.left = left;
+  node.right = right;
+
+  int index = tree.size() - 1;
+  extendOutputs(S, index, rhs + 1 < node.inputs ? rhs + 1 : node.inputs);
+  return index;
 }
 
-void Totalizer::join(Solver *S, vec<Lit> &lits, int64_t rhs) {
+int Totalizer::buildTree(Solver *S, vec<Lit> &lits, int begin, int end,
+                         int64_t rhs) {
+  assert(end > begin);
+  if (end - begin == 1)
+    return newLeaf(lits[begin]);
 
-  assert(incremental_strategy == _INCREMENTAL_ITERATIVE_);
+  int split = begin + (end - begin) / 2;
+  int left = buildTree(S, lits, begin, split, rhs);
+  int right = buildTree(S, lits, split, end, rhs);
+  return newNode(S, left, right, rhs);
+}
 
-  vec<Lit> left_cardinality_outlits;
-  cardinality_outlits.copyTo(left_cardinality_outlits);
-  int old_cardinality = current_cardinality_rhs;
+void Totalizer::increase(Solver *S, int node, int64_t rhs) {
+  int size = rhs + 1 < tree[node].inputs ? rhs + 1 : tree[node].inputs;
+  // Leaves always have their only output.
+  if (size <= tree[node].outputs.size())
+    return;
 
-  if (lits.size() > 1) {
-    build(S, lits, rhs < lits.size() ? rhs : lits.size());
-  } else {
-    assert(lits.size() == 1);
-    cardinality_outlits.clear();
-    cardinality_outlits.push(lits[0]);
-  }
+  increase(S, tree[node].left, rhs);
+  increase(S, tree[node].right, rhs);
+  extendOutputs(S, node, size);
+}
 
-  vec<Lit> right_cardinality_outlits;
-  cardinality_outlits.copyTo(right_cardinality_outlits);
-  cardinality_outlits.clear();
+// Adds the outputs of 'node' up to 'size' and the clauses that define them.
+// Assumes that the children already have all the outputs they need.
+void Totalizer::extendOutputs(Solver *S, int node, int size) {
+  vec<Lit> &output = tree[node].outputs;
+  vec<Lit> &left = tree[tree[node].left].outputs;
+  vec<Lit> &right = tree[tree[node].right].outputs;
+  int last = output.size();
 
-  for (int i = 0;
-       i < left_cardinality_outlits.size() + right_cardinality_outlits.size();
-       i++) {
+  for (int i = last; i < size; i++) {
     Lit p = mkLit(S->nVars(), false);
     newSATVariable(S);
     n_variables++;
-    cardinality_outlits.push(p);
+    output.push(p);
   }
 
-  current_cardinality_rhs = rhs;
-  // TO_adder is using the 'current_cardinality_rhs' value
-  adder(S, left_cardinality_outlits, right_cardinality_outlits,
-        cardinality_outlits);
-  current_cardinality_rhs = old_cardinality;
+  // Only the clauses of the new outputs are added, i.e. i + j > last.
+  for (int i = 0; i <= left.size() && i <= size; i++) {
+    for (int j = 0; j <= right.size() && i + j <= size; j++) {
+      if (i + j <= last)
+        continue;
+
+      if (i == 0) {
+        addBinaryClause(S, ~right[j - 1], output[j - 1], blocking);
+        n_clauses++;
+      } else if (j == 0) {
+        addBinaryClause(S, ~left[i - 1], output[i - 1], blocking);
+        n_clauses++;
+      } else {
+        addTernaryClause(S, ~left[i - 1], ~right[j - 1], output[i + j - 1],
+                         blocking);
+        n_clauses++;
+      }
+    }
+  }
+}
+
+void Totalizer::incremental(Solver *S, int64_t rhs) {
+  assert(root != -1);
+  increase(S, root, rhs);
+  tree[root].outputs.copyTo(cardinality_outlits);
+}
+
+void Totalizer::join(Solver *S, vec<Lit> &lits, int64_t rhs) {
+
+  assert(incremental_strategy == _INCREMENTAL_ITERATIVE_);
+  assert(root != -1 && lits.size() > 0);
+
+  int right = buildTree(S, lits, 0, lits.size(), rhs);
+  root = newNode(S, root, right, rhs);
+  tree[root].outputs.copyTo(cardinality_outlits);
 
   for (int i = 0; i < lits.size(); i++)
     ilits.push(lits[i]);
@@ -107,21 +152,6 @@ void Totalizer::join(Solver *S, vec<Lit> &lits, int64_t rhs) {
 void Totalizer::adder(Solver *S, vec<Lit> &left, vec<Lit> &right,
                       vec<Lit> &output) {
   assert(output.size() == left.size() + right.size());
-  if (incremental_strategy == _INCREMENTAL_ITERATIVE_) {
-    totalizerIterative_left.push();
-    new (&totalizerIterative_left[totalizerIterative_left.size() - 1])
-        vec<Lit>();
-    left.copyTo(totalizerIterative_left.last());
-    totalizerIterative_right.push();
-    new (&totalizerIterative_right[totalizerIterative_right.size() - 1])
-        vec<Lit>();
-    right.copyTo(totalizerIterative_right.last());
-    totalizerIterative_output.push();
-    new (&totalizerIterative_output[totalizerIterative_output.size() - 1])
-        vec<Lit>();
-    output.copyTo(totalizerIterative_output.last());
-    totalizerIterative_rhs.push(current_cardinality_rhs);
-  }
 
   // We only need to count the sums up to k.
   for (int i = 0; i <= left.size(); i++) {
@@ -240,35 +270,25 @@ void Totalizer::update(Solver *S, int64_t rhs, vec<Lit> &lits,
 void Totalizer::add(Solver *S, Totalizer &tot, int64_t rhs) {
   assert(incremental_strategy == _INCREMENTAL_ITERATIVE_ &&
          tot.incremental_strategy == _INCREMENTAL_ITERATIVE_);
-  int left_idx = totalizerIterative_rhs.size() - 1;
-  for (int i = 0; i < tot.totalizerIterative_rhs.size(); ++i) {
-    totalizerIterative_left.push();
-    new (&totalizerIterative_left[totalizerIterative_left.size() - 1])
-        vec<Lit>();
-    tot.totalizerIterative_left[i].copyTo(totalizerIterative_left.last());
-    totalizerIterative_right.push();
-    new (&totalizerIterative_right[totalizerIterative_right.size() - 1])
-        vec<Lit>();
-    tot.totalizerIterative_right[i].copyTo(totalizerIterative_right.last());
-    totalizerIterative_output.push();
-    new (&totalizerIterative_output[totalizerIterative_output.size() - 1])
-        vec<Lit>();
-    tot.totalizerIterative_output[i].copyTo(totalizerIterative_output.last());
-    totalizerIterative_rhs.push(tot.totalizerIterative_rhs[i]);
+  assert(root != -1 && tot.root != -1);
+
+  // Copy the tree of 'tot' and merge both roots.
+  int offset = tree.size();
+  for (int i = 0; i < tot.tree.size(); i++) {
+    tree.push();
+    TotNode &node = tree.last();
+    tot.tree[i].outputs.copyTo(node.outputs);
+    node.inputs = tot.tree[i].inputs;
+    node.left = tot.tree[i].left == -1 ? -1 : tot.tree[i].left + offset;
+    node.right = tot.tree[i].right == -1 ? -1 : tot.tree[i].right + offset;
   }
-  int right_idx = totalizerIterative_rhs.size() - 1;
 
-  vec<Lit> left, right;
-  totalizerIterative_output[left_idx].copyTo(left);
-  totalizerIterative_output[right_idx].copyTo(right);
-  cardinality_outlits.clear();
-  for (int i = 0; i < left.size() + right.size(); ++i) {
-    Lit p = mkLit(S->nVars(), false);
-    newSATVariable(S);
-    cardinality_outlits.push(p);
-  }
+  root = newNode(S, root, tot.root + offset, rhs);
+  tree[root].outputs.copyTo(cardinality_outlits);
   current_cardinality_rhs = rhs;
-  adder(S, left, right, cardinality_outlits);
+
+  for (int i = 0; i < tot.ilits.size(); i++)
+    ilits.push(tot.ilits[i]);
 }
 
 /*_________________________________________________________________________________________________
@@ -315,6 +335,17 @@ void Totalizer::build(Solver *S, vec<Lit> &lits, int64_t rhs) {
   if (rhs == lits.size() && !joinMode)
     return;
 
+  if (incremental_strategy == _INCREMENTAL_ITERATIVE_) {
+    tree.clear();
+    root = buildTree(S, lits, 0, lits.size(), rhs);
+    tree[root].outputs.copyTo(cardinality_outlits);
+    current_cardinality_rhs = rhs;
+    joinMode = true;
+    hasEncoding = true;
+    lits.copyTo(ilits);
+    return;
+  }
+
   for (int i = 0; i < lits.size(); i++) {
     Lit p = mkLit(S->nVars(), false);
     newSATVariable(S);
@@ -48,6 +48,7 @@ public:
     joinMode = false;
     current_cardinality_rhs = -1; // -1 corresponds to an unitialized value
     incremental_strategy = strategy;
+    root = -1;
 
     n_clauses = 0;
     n_variables = 0;
@@ -99,15 +100,29 @@ public:
   vec<Lit> &outputs() { return cardinality_outlits; }
 
 protected:
+  // Node of the iterative totalizer tree. A node only has the outputs needed
+  // for the current rhs, i.e. min(rhs+1, inputs), and gets more outputs when
+  // the rhs is increased (see 'increase').
+  struct TotNode {
+    vec<Lit> outputs;
+    int inputs;
+    int left;
+    int right;
+  };
+
   void encode(Solver *S, vec<Lit> &lits);
   void adder(Solver *S, vec<Lit> &left, vec<Lit> &right, vec<Lit> &output);
   void incremental(Solver *S, int64_t rhs);
   void toCNF(Solver *S, vec<Lit> &lits);
 
-  vec<vec<Lit>> totalizerIterative_left;
-  vec<vec<Lit>> totalizerIterative_right;
-  vec<vec<Lit>> totalizerIterative_output;
-  vec<int64_t> totalizerIterative_rhs;
+  int newLeaf(Lit l);
+  int newNode(Solver *S, int left, int right, int64_t rhs);
+  int buildTree(Solver *S, vec<Lit> &lits, int begin, int end, int64_t rhs);
+  void increase(Solver *S, int node, int64_t rhs);
+  void extendOutputs(Solver *S, int node, int size);
+
+  vec<TotNode> tree; // Nodes of the iterative totalizer.
+  int root;          // Root of the iterative totalizer, -1 if there is none.
 
   Lit blocking; // Controls the blocking literal for the incremental blocking.
   bool hasEncoding;
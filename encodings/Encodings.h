@@ -35,6 +35,7 @@
 #endif
 
 #include "../MaxTypes.h"
+#include "../SATSolver.h"
 #include "core/SolverTypes.h"
 
 using NSPACE::vec;
@@ -42,7 +43,7 @@ using NSPACE::Lit;
 using NSPACE::mkLit;
 using NSPACE::lit_Error;
 using NSPACE::lit_Undef;
-using NSPACE::Solver;
+using openwbo::Solver;
 
 namespace openwbo {
 
@@ -67,13 +68,7 @@ public:
                            Lit blocking = lit_Undef);
 
   // Creates a new variable in the SAT solver
-  void newSATVariable(Solver *S) {
-#ifdef SIMP
-    ((NSPACE::SimpSolver *)S)->newVar();
-#else
-    S->newVar();
-#endif
-  }
+  void newSATVariable(Solver *S) { S->newVar(); }
 
 protected:
   vec<Lit> clause; // Temporary clause to be used while building the encodings.
@@ -36,11 +36,11 @@ using namespace openwbo;
 Graph::Graph(int nVert) {
   _nSCC = 0;
   _nVert = nVert;
-  _edges.growTo(_nVert);
-  _weights.growTo(_nVert);
+  _offsets.growTo(_nVert + 1, 0);
   _incomingEdges.growTo(_nVert);
   _totalWeights.growTo(_nVert);
   _nSelfLoops.growTo(_nVert);
+  _marks.growTo(_nVert, WHITE);
 
   _nMarked = 0;
   _totalWeight = 0.0;
@@ -58,55 +58,94 @@ void Graph::addEdge(int u, int v, double w) {
   if (u == v)
     _nSelfLoops[u] += w;
 
-  _edges[u].push(v);
-  _weights[u].push(w);
-  _incomingEdges[v]++;
+  _edgeSources.push(u);
+  _edgeTargets.push(v);
+  _edgeBufferWeights.push(w);
 
   _totalWeights[u] += w;
   _totalWeight += w;
 }
 
 int Graph::nEdges() {
-  int e = 0;
   mergeDuplicatedEdges();
-  for (int i = 0; i < _nVert; i++)
-    e += _edges[i].size();
-  return e;
+  return _targets.size();
 }
 
-// Remove duplicated edges. O(V+E)
+// Builds the CSR adjacency from the buffered edges (and the edges already in
+// it): two counting sorts order the edges by source and target, so that the
+// duplicated edges are consecutive and merged in a single pass. O(V+E)
 
 void Graph::mergeDuplicatedEdges() {
-  // vmm - Vectors on stack?!?! Is this a good idea for large graphs?!?!
-  vec<int> destVertexes;
-  vec<double> w;
-  int n = 0;
-
-  w.growTo(_nVert);
-  destVertexes.growTo(_nVert);
-  for (int i = 0; i < _nVert; i++)
-    w[i] = 0;
-
-  for (int i = 0; i < _nVert; i++) {
-    if (_edges[i].size() > 0) {
-      for (int j = 0; j < _edges[i].size(); j++) {
-        int v = _edges[i][j];
-        if (w[v] == 0)
-          destVertexes[n++] = v; // New destination vertex
-        else
-          _incomingEdges[v]--; // Duplicated edge
-        w[v] += _weights[i][j];
-      }
+  int nNew = _edgeSources.size();
+  if (nNew == 0)
+    return;
+
+  int m = _targets.size() + nNew;
+  vec<int> src(m), dst(m);
+  vec<double> w(m);
+  int k = 0;
+  for (int u = 0; u < _nVert; u++) {
+    for (int i = _offsets[u]; i < _offsets[u + 1]; i++, k++) {
+      src[k] = u;
+      dst[k] = _targets[i];
+      w[k] = _edgeWeights[i];
+    }
+  }
+  for (int i = 0; i < nNew; i++, k++) {
+    src[k] = _edgeSources[i];
+    dst[k] = _edgeTargets[i];
+    w[k] = _edgeBufferWeights[i];
+  }
+  _edgeSources.clear(true);
+  _edgeTargets.clear(true);
+  _edgeBufferWeights.clear(true);
+
+  // Order by target...
+  vec<int> start(_nVert + 1, 0);
+  vec<int> order(m);
+  for (int i = 0; i < m; i++)
+    start[dst[i] + 1]++;
+  for (int v = 0; v < _nVert; v++)
+    start[v + 1] += start[v];
+  for (int i = 0; i < m; i++)
+    order[start[dst[i]]++] = i;
+
+  // ... and (stable) by source
+  for (int u = 0; u <= _nVert; u++)
+    _offsets[u] = 0;
+  for (int i = 0; i < m; i++)
+    _offsets[src[i] + 1]++;
+  for (int u = 0; u < _nVert; u++)
+    _offsets[u + 1] += _offsets[u];
+  _offsets.copyTo(start);
+  _targets.growTo(m);
+  _edgeWeights.growTo(m);
+  for (int j = 0; j < m; j++) {
+    int i = order[j];
+    int p = start[src[i]]++;
+    _targets[p] = dst[i];
+    _edgeWeights[p] = w[i];
+  }
 
-      for (int j = 0; j < n; j++) {
-        _edges[i][j] = destVertexes[j];
-        _weights[i][j] = w[destVertexes[j]];
-        w[destVertexes[j]] = 0;
+  // Merge consecutive duplicated edges
+  int n = 0;
+  for (int v = 0; v < _nVert; v++)
+    _incomingEdges[v] = 0;
+  for (int u = 0; u < _nVert; u++) {
+    int begin = _offsets[u];
+    _offsets[u] = n;
+    for (int i = begin; i < _offsets[u + 1]; i++) {
+      if (n > _offsets[u] && _targets[n - 1] == _targets[i])
+        _edgeWeights[n - 1] += _edgeWeights[i];
+      else {
+        _targets[n] = _targets[i];
+        _edgeWeights[n] = _edgeWeights[i];
+        _incomingEdges[_targets[n]]++;
+        n++;
       }
-
-      _edges[i].shrink_(_edges[i].size() - n);
-      _weights[i].shrink_(_weights[i].size() - n);
-      n = 0;
     }
   }
+  _offsets[_nVert] = n;
+  _targets.shrink_(m - n);
+  _edgeWeights.shrink_(m - n);
 }
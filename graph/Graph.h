@@ -42,20 +42,40 @@ enum color_ { WHITE, GRAY, BLACK };
 
 class Graph {
 public:
+  // Read-only view of the edges (or weights) of a vertex.
+  template <class T> class Range {
+  public:
+    Range(const T *data, int size) : _data(data), _size(size) {}
+    inline int size() const { return _size; }
+    inline const T &operator[](int i) const { return _data[i]; }
+
+  private:
+    const T *_data;
+    int _size;
+  };
+
   // Constructor/Destructor:
   //
   Graph(int nVert);
   ~Graph();
 
+  // Edges are buffered until mergeDuplicatedEdges() builds the compressed
+  // (CSR) adjacency, which must be called before the edges are read.
   void addEdge(int u, int v, double w = 1.0);
   int nEdges();
   void mergeDuplicatedEdges();
 
   // Stats
   inline int nVertexes() { return _nVert; }
-  inline vec<int> &vertexEdges(int u) { return _edges[u]; }
-  inline vec<double> &vertexWeights(int u) { return _weights[u]; }
-  inline int nNeighbors(int u) { return _edges[u].size(); }
+  inline Range<int> vertexEdges(int u) {
+    return Range<int>((int *)_targets + _offsets[u],
+                      _offsets[u + 1] - _offsets[u]);
+  }
+  inline Range<double> vertexWeights(int u) {
+    return Range<double>((double *)_edgeWeights + _offsets[u],
+                         _offsets[u + 1] - _offsets[u]);
+  }
+  inline int nNeighbors(int u) { return _offsets[u + 1] - _offsets[u]; }
   inline int nIncomingEdges(int u) { return _incomingEdges[u]; }
   inline double nSelfLoops(int u) { return _nSelfLoops[u]; }
 
@@ -99,8 +119,18 @@ protected:
 
 protected:
   int _nVert;
-  vec<vec<int>> _edges;
-  vec<vec<double>> _weights;
+
+  // Edges added since the last mergeDuplicatedEdges()
+  vec<int> _edgeSources;
+  vec<int> _edgeTargets;
+  vec<double> _edgeBufferWeights;
+
+  // CSR adjacency: the edges of u are _targets[_offsets[u].._offsets[u+1]-1]
+  // sorted by target, with their weights in _edgeWeights
+  vec<int> _offsets;
+  vec<int> _targets;
+  vec<double> _edgeWeights;
+
   vec<double> _totalWeights;
   double _totalWeight;
   vec<int> _incomingEdges;
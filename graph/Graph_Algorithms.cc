@@ -60,9 +60,9 @@ void Graph::DFSVisitIter(int u, vec<int> &reachedVertexes) {
     if (_marks[u] == WHITE) {
       _marks[u] = BLACK;
 
-      for (int i = 0; i < _edges[u].size(); i++) {
-        if (_marks[_edges[u][i]] == WHITE) {
-          l->push(_edges[u][i]);
+      for (int i = _offsets[u]; i < _offsets[u + 1]; i++) {
+        if (_marks[_targets[i]] == WHITE) {
+          l->push(_targets[i]);
         }
       }
       reachedVertexes.push(u);
@@ -77,9 +77,9 @@ void Graph::DFSVisit(int u, vec<int> &reachedVertexes) {
   if (_marks[u] == WHITE) {
     _marks[u] = BLACK;
 
-    for (int i = 0; i < _edges[u].size(); i++) {
-      if (_marks[_edges[u][i]] == WHITE) {
-        DFSVisit(_edges[u][i], reachedVertexes);
+    for (int i = _offsets[u]; i < _offsets[u + 1]; i++) {
+      if (_marks[_targets[i]] == WHITE) {
+        DFSVisit(_targets[i], reachedVertexes);
       }
     }
     reachedVertexes.push(u);
@@ -88,7 +88,7 @@ void Graph::DFSVisit(int u, vec<int> &reachedVertexes) {
 
 void Graph::topologicalSort(vec<int> &vertexes) {
   for (int i = 0; i < _nVert; i++) {
-    if (_marks[i] == WHITE && _edges[i].size()) {
+    if (_marks[i] == WHITE && nNeighbors(i)) {
       DFSVisit(i, vertexes);
     }
   }
@@ -101,7 +101,7 @@ int Graph::connectedComponents() {
   vec<int> vertexes;
 
   for (int i = 0; i < _nVert; i++) {
-    if (_marks[i] == WHITE && _edges[i].size()) {
+    if (_marks[i] == WHITE && nNeighbors(i)) {
       n++;
       DFSVisitIter(i, vertexes);
     }
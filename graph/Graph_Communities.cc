@@ -33,16 +33,20 @@
 
 #include "mtl/Vec.h"
 
-#include <map>
+#include <algorithm>
+#include <functional>
 
 using namespace openwbo;
 
 #define PRECISION 0.000001
+// Smallest graph whose local moves are made in parallel
+#define PARALLEL_VERTEXES 10000
 
 Graph_Communities::Graph_Communities() {
   _nCommunities = 0;
   _modularity = 0.0;
   _g = NULL;
+  _nThreads = 1;
 }
 
 Graph_Communities::~Graph_Communities() {}
@@ -94,15 +98,33 @@ int Graph_Communities::findCommunities(int mode, Graph *g) {
   return _nCommunities;
 }
 
+int Graph_Communities::setCommunities(Graph *g) {
+  _g = g;
+  if (_vertexCommunity.size() > 0)
+    _vertexCommunity.clear();
+  _vertexCommunity.growTo(_g->nVertexes());
+  for (int i = 0; i < g->nVertexes(); i++)
+    _vertexCommunity[i] = i;
+
+  resetInternalData();
+  _modularity = modularity();
+  _nCommunities = g->nVertexes();
+
+  return _nCommunities;
+}
+
 /// Internal
 
 bool Graph_Communities::iterate() {
+  if (_nThreads > 1 && _g->nVertexes() >= PARALLEL_VERTEXES)
+    return iterateParallel();
+
   double new_mod = modularity();
   double cur_mod = new_mod;
   bool better = false;
 
   // Generates a random order of vertexes
-  int random_order[_g->nVertexes()];
+  vec<int> random_order(_g->nVertexes());
   for (int i = 0; i < _g->nVertexes(); i++)
     random_order[i] = i;
 
@@ -157,9 +179,153 @@ bool Graph_Communities::iterate() {
   return better;
 }
 
+// Parallel local moves: every vertex picks its best community given the
+// communities of the previous sweep, and all the moves are applied at once.
+// A vertex alone in its community only joins another single vertex with a
+// smaller community id, so that two vertexes do not swap communities forever.
+// A sweep that decreases the modularity (simultaneous moves may conflict) is
+// undone and ends the phase. The result does not depend on the number of
+// threads, so they are capped by the cores and by the vertexes (every thread
+// keeps a weight per community).
+bool Graph_Communities::iterateParallel() {
+  int n = _g->nVertexes();
+  int nThreads = std::min(_nThreads, n / PARALLEL_VERTEXES);
+  if (std::thread::hardware_concurrency() > 0)
+    nThreads = std::min(nThreads, (int)std::thread::hardware_concurrency());
+  double new_mod = modularity();
+  double cur_mod = new_mod;
+  bool better = false;
+
+  vec<int> size(n, 0);
+  for (int i = 0; i < n; i++)
+    size[_vertexToComm[i]]++;
+
+  vec<int> target(n);
+  vec<int> old_comm;
+  vec<double> old_inside, old_total;
+  vec<vec<double>> adj_weight(nThreads);
+  for (int t = 0; t < nThreads; t++)
+    adj_weight[t].growTo(n, -1.0);
+
+  for (;;) {
+    cur_mod = new_mod;
+
+    vector<thread> threads;
+    int chunk = (n + nThreads - 1) / nThreads;
+    for (int t = 0; t < nThreads; t++)
+      threads.push_back(thread(&Graph_Communities::bestCommunities, this,
+                               t * chunk, min(n, (t + 1) * chunk),
+                               std::ref(target), std::ref(size),
+                               std::ref(adj_weight[t])));
+    for (int t = 0; t < nThreads; t++)
+      threads[t].join();
+
+    _vertexToComm.copyTo(old_comm);
+    _inside.copyTo(old_inside);
+    _total.copyTo(old_total);
+
+    int moves = 0;
+    for (int v = 0; v < n; v++) {
+      if (target[v] == _vertexToComm[v])
+        continue;
+      _total[_vertexToComm[v]] -= _g->weightedDegree(v);
+      _total[target[v]] += _g->weightedDegree(v);
+      size[_vertexToComm[v]]--;
+      size[target[v]]++;
+      _vertexToComm[v] = target[v];
+      moves++;
+    }
+    if (moves == 0)
+      break;
+
+    // Edges inside the communities: every edge is stored in both directions,
+    // the reverse edge of a moved vertex to a vertex that stays is counted
+    // with it
+    for (int v = 0; v < n; v++) {
+      int from = old_comm[v], to = _vertexToComm[v];
+      if (from == to)
+        continue;
+      _inside[from] -= _g->nSelfLoops(v);
+      _inside[to] += _g->nSelfLoops(v);
+      Graph::Range<int> edges = _g->vertexEdges(v);
+      Graph::Range<double> weights = _g->vertexWeights(v);
+      for (int i = 0; i < edges.size(); i++) {
+        int u = edges[i];
+        if (u == v)
+          continue;
+        double w = old_comm[u] == _vertexToComm[u] ? 2 * weights[i] : weights[i];
+        if (old_comm[u] == from)
+          _inside[from] -= w;
+        if (_vertexToComm[u] == to)
+          _inside[to] += w;
+      }
+    }
+
+    new_mod = modularity();
+    if (new_mod < cur_mod) {
+      old_comm.copyTo(_vertexToComm);
+      old_inside.copyTo(_inside);
+      old_total.copyTo(_total);
+      break;
+    }
+    better = true;
+    if (new_mod - cur_mod <= PRECISION)
+      break;
+  }
+
+  return better;
+}
+
+// Best community of the vertexes in [begin,end), adj_weight is -1 for every
+// community (and is left so)
+void Graph_Communities::bestCommunities(int begin, int end, vec<int> &target,
+                                        vec<int> &size,
+                                        vec<double> &adj_weight) {
+  vec<int> adj_comm;
+
+  for (int vertex = begin; vertex < end; vertex++) {
+    Graph::Range<int> edges = _g->vertexEdges(vertex);
+    Graph::Range<double> weights = _g->vertexWeights(vertex);
+    int comm = _vertexToComm[vertex];
+    double degree = _g->weightedDegree(vertex);
+    double factor = degree / _g->totalWeight();
+
+    adj_comm.clear();
+    adj_comm.push(comm);
+    adj_weight[comm] = 0.0;
+    for (int i = 0; i < edges.size(); i++) {
+      if (edges[i] == vertex)
+        continue;
+      int c = _vertexToComm[edges[i]];
+      if (adj_weight[c] < 0) {
+        adj_weight[c] = 0.0;
+        adj_comm.push(c);
+      }
+      adj_weight[c] += weights[i];
+    }
+
+    int best_comm = comm;
+    double best_variation = 0.0;
+    for (int i = 0; i < adj_comm.size(); i++) {
+      int c = adj_comm[i];
+      double total = c == comm ? _total[c] - degree : _total[c];
+      double variation = adj_weight[c] - total * factor;
+      if (variation > best_variation) {
+        best_comm = c;
+        best_variation = variation;
+      }
+      adj_weight[c] = -1.0;
+    }
+
+    if (size[comm] == 1 && size[best_comm] == 1 && best_comm > comm)
+      best_comm = comm;
+    target[vertex] = best_comm;
+  }
+}
+
 void Graph_Communities::computeAdjCommunities(int vertex) {
-  vec<int> &edges = _g->vertexEdges(vertex);
-  vec<double> &weights = _g->vertexWeights(vertex);
+  Graph::Range<int> edges = _g->vertexEdges(vertex);
+  Graph::Range<double> weights = _g->vertexWeights(vertex);
 
   // Reset internal vectors
   for (int i = 0; i < _adjComm.size(); i++) {
@@ -199,38 +365,17 @@ Graph *Graph_Communities::nextIterationGraph() {
     if (_renumber[i] != 0)
       _renumber[i] = _nCommunities++;
 
-  // Compute which vertexes belong to each community
-  _communities.clear();
-  _communities.growTo(_nCommunities);
-  for (int i = 0; i < _g->nVertexes(); i++)
-    _communities[_renumber[_vertexToComm[i]]].push(i);
-
-  // Compute new weighted graph with colapsed communities
+  // Compute new weighted graph with colapsed communities, the edges between
+  // the same communities are merged when the graph is built
   Graph *g2 = new Graph(_nCommunities);
 
-  for (int comm = 0; comm < _nCommunities; comm++) {
-    map<int, double> m;
-    map<int, double>::iterator it;
-    int comm_size = _communities[comm].size();
-
-    for (int u = 0; u < comm_size; u++) {
-      vec<int> &edges = _g->vertexEdges(_communities[comm][u]);
-      vec<double> &weights = _g->vertexWeights(_communities[comm][u]);
-
-      for (int i = 0; i < edges.size(); i++) {
-        int v = edges[i];
-        int new_id = _renumber[_vertexToComm[v]];
-
-        it = m.find(new_id);
-        if (it == m.end())
-          m.insert(make_pair(new_id, weights[i]));
-        else
-          it->second += weights[i];
-      }
-    }
+  for (int u = 0; u < _g->nVertexes(); u++) {
+    Graph::Range<int> edges = _g->vertexEdges(u);
+    Graph::Range<double> weights = _g->vertexWeights(u);
+    int comm = _renumber[_vertexToComm[u]];
 
-    for (it = m.begin(); it != m.end(); it++)
-      g2->addEdge(comm, it->first, it->second);
+    for (int i = 0; i < edges.size(); i++)
+      g2->addEdge(comm, _renumber[_vertexToComm[edges[i]]], weights[i]);
   }
 
   g2->mergeDuplicatedEdges();
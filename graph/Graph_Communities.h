@@ -30,6 +30,8 @@
 
 #include "Graph.h"
 #include <string.h>
+#include <thread>
+#include <vector>
 
 #include "mtl/Vec.h"
 
@@ -47,21 +49,30 @@ public:
   ~Graph_Communities();
 
   int findCommunities(int mode, Graph *g);
+  // Every vertex of g is a community, for partitions given by the caller.
+  int setCommunities(Graph *g);
 
   // Valid after findCommunities is called.
   inline int nCommunities() { return _nCommunities; }
   inline int vertexCommunity(int u) { return _vertexCommunity[u]; }
   inline double getModularity() { return _modularity; }
 
-  inline const vec<int> &adjCommunities(int c) { return _g->vertexEdges(c); }
-  inline const vec<double> &adjCommunityWeights(int c) {
+  inline Graph::Range<int> adjCommunities(int c) { return _g->vertexEdges(c); }
+  inline Graph::Range<double> adjCommunityWeights(int c) {
     return _g->vertexWeights(c);
   }
 
+  // Threads for the local moves of large graphs, with more than one the moves
+  // are made in parallel whatever the cores (default: 1, sequential).
+  inline void setThreads(int n) { _nThreads = n; }
+
 protected:
   // Unfolding method
   Graph *nextIterationGraph();
   bool iterate();
+  bool iterateParallel();
+  void bestCommunities(int begin, int end, vec<int> &target, vec<int> &size,
+                       vec<double> &adj_weight);
   void computeAdjCommunities(int node);
 
   void resetInternalData();
@@ -83,7 +94,6 @@ protected:
 
   // Unfolding method - Utils
   vec<int> _vertexToComm;     // mapping of vertexes to communities
-  vec<vec<int>> _communities; // vertexes of each community
   vec<double> _inside;        // total weight of edges inside each community
   vec<double> _total; // total weight of edges of vertexes in each community
                       // (inside and outside edges)
@@ -94,6 +104,8 @@ protected:
 
   vec<int> _renumber;
 
+  int _nThreads;
+
   // Label propagation method
 };
 
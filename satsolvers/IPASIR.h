@@ -0,0 +1,63 @@
+/*!
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef IPASIR_h
+#define IPASIR_h
+
+#include <stdint.h>
+
+// The SAT solvers that are linked next to Glucose 4.1 are compiled against
+// their own headers, so nothing but this file is shared with them. Each one
+// fills a table with the functions of the IPASIR interface
+// (https://github.com/biotomas/ipasir): literals are non-zero integers, the
+// sign gives the polarity, and variables are created by using them.
+struct IPASIRFunctions {
+  const char *(*signature)();
+  void *(*init)();
+  void (*release)(void *solver);
+  // Adds a literal to the clause under construction, 0 closes it.
+  void (*add)(void *solver, int lit_or_zero);
+  // Assumes a literal for the next call only.
+  void (*assume)(void *solver, int lit);
+  // Returns 10 (satisfiable), 20 (unsatisfiable) or 0 (interrupted).
+  int (*solve)(void *solver);
+  // Value of a literal in the model: 'lit', '-lit' or 0.
+  int (*val)(void *solver, int lit);
+  // 1 if the assumption 'lit' was used to prove unsatisfiability.
+  int (*failed)(void *solver, int lit);
+
+  // Extensions: conflict budget of the next calls (negative for none),
+  // interruption (safe from a signal handler), preferred polarity of the
+  // variable of 'lit', and decision variables.
+  void (*set_conflict_limit)(void *solver, int64_t limit);
+  void (*interrupt)(void *solver, int on);
+  void (*set_phase)(void *solver, int lit);
+  void (*set_decision)(void *solver, int var, int on);
+};
+
+const IPASIRFunctions *minisat22IPASIR();
+const IPASIRFunctions *glucose40IPASIR();
+
+#endif
@@ -0,0 +1,150 @@
+/*!
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+// IPASIR functions of a solver with the API of MiniSat 2.2, included by the
+// translation unit of the solver after its "core/Solver.h" with
+//   IPASIR_NSPACE     namespace of the solver,
+//   IPASIR_SIGNATURE  name and version of the solver,
+//   IPASIR_TABLE      name of the function returning the table,
+//   IPASIR_INIT(S)    (optional) set up of a new solver.
+
+#include <stdlib.h>
+
+#include "IPASIR.h"
+
+namespace {
+
+using IPASIR_NSPACE::Lit;
+using IPASIR_NSPACE::Solver;
+using IPASIR_NSPACE::lbool;
+using IPASIR_NSPACE::vec;
+
+struct IPASIRState {
+  Solver solver;
+  vec<Lit> clause;
+  vec<Lit> assumptions;
+  vec<char> failed; // Indexed by literal, set after an unsatisfiable call.
+};
+
+inline Lit toSolverLit(IPASIRState *s, int lit) {
+  int v = abs(lit) - 1;
+  while (v >= s->solver.nVars())
+    s->solver.newVar();
+  return IPASIR_NSPACE::mkLit(v, lit < 0);
+}
+
+const char *ipasirSignature() { return IPASIR_SIGNATURE; }
+
+void *ipasirInit() {
+  IPASIRState *s = new IPASIRState();
+#ifdef IPASIR_INIT
+  IPASIR_INIT((&s->solver));
+#endif
+  return s;
+}
+
+void ipasirRelease(void *solver) { delete (IPASIRState *)solver; }
+
+void ipasirAdd(void *solver, int lit_or_zero) {
+  IPASIRState *s = (IPASIRState *)solver;
+  if (lit_or_zero != 0) {
+    s->clause.push(toSolverLit(s, lit_or_zero));
+    return;
+  }
+  s->solver.addClause_(s->clause);
+  s->clause.clear();
+}
+
+void ipasirAssume(void *solver, int lit) {
+  IPASIRState *s = (IPASIRState *)solver;
+  s->assumptions.push(toSolverLit(s, lit));
+}
+
+int ipasirSolve(void *solver) {
+  IPASIRState *s = (IPASIRState *)solver;
+  lbool res = s->solver.solveLimited(s->assumptions);
+  s->assumptions.clear();
+  s->failed.clear();
+  if (res == l_False) {
+    s->failed.growTo(2 * s->solver.nVars(), 0);
+    for (int i = 0; i < s->solver.conflict.size(); i++)
+      s->failed[toInt(~s->solver.conflict[i])] = 1;
+    return 20;
+  }
+  return res == l_True ? 10 : 0;
+}
+
+int ipasirVal(void *solver, int lit) {
+  IPASIRState *s = (IPASIRState *)solver;
+  int v = abs(lit) - 1;
+  if (v >= s->solver.model.size())
+    return 0;
+  lbool value = s->solver.model[v];
+  if (value == l_Undef)
+    return 0;
+  return (value == l_True) == (lit > 0) ? lit : -lit;
+}
+
+int ipasirFailed(void *solver, int lit) {
+  IPASIRState *s = (IPASIRState *)solver;
+  int l = 2 * (abs(lit) - 1) + (lit < 0);
+  return l < s->failed.size() && s->failed[l];
+}
+
+void ipasirSetConflictLimit(void *solver, int64_t limit) {
+  IPASIRState *s = (IPASIRState *)solver;
+  if (limit < 0)
+    s->solver.budgetOff();
+  else
+    s->solver.setConfBudget(limit);
+}
+
+void ipasirInterrupt(void *solver, int on) {
+  IPASIRState *s = (IPASIRState *)solver;
+  if (on)
+    s->solver.interrupt();
+  else
+    s->solver.clearInterrupt();
+}
+
+void ipasirSetPhase(void *solver, int lit) {
+  IPASIRState *s = (IPASIRState *)solver;
+  s->solver.setPolarity(var(toSolverLit(s, lit)), lit < 0);
+}
+
+void ipasirSetDecision(void *solver, int v, int on) {
+  IPASIRState *s = (IPASIRState *)solver;
+  s->solver.setDecisionVar(var(toSolverLit(s, v)), on);
+}
+
+const IPASIRFunctions ipasirFunctions = {
+    ipasirSignature, ipasirInit,   ipasirRelease,          ipasirAdd,
+    ipasirAssume,    ipasirSolve,  ipasirVal,              ipasirFailed,
+    ipasirSetConflictLimit,        ipasirInterrupt,        ipasirSetPhase,
+    ipasirSetDecision};
+
+} // namespace
+
+const IPASIRFunctions *IPASIR_TABLE() { return &ipasirFunctions; }
@@ -0,0 +1,94 @@
+/*!
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef Sat_Glucose41_h
+#define Sat_Glucose41_h
+
+#include "simp/SimpSolver.h"
+
+#include "../SATSolver.h"
+
+namespace openwbo {
+
+//=================================================================================================
+// Glucose 4.1, the solver of the build (NSPACE). It is used directly, all the
+// hints of the interface reach it.
+class Glucose41 : public SATSolver {
+
+public:
+  Glucose41(bool simplify) {
+    simp = simplify ? new NSPACE::SimpSolver() : NULL;
+    solver = simplify ? simp : new NSPACE::Solver();
+  }
+  ~Glucose41() { delete solver; }
+
+  const char *name() { return "Glucose 4.1"; }
+
+  Var newVar() { return solver->newVar(); }
+  int nVars() { return solver->nVars(); }
+  void reserveVars(Var maxVariable) {
+#ifdef SAT_HAS_RESERVATION
+    solver->reserveVars(maxVariable);
+#endif
+  }
+  bool addClause_(vec<Lit> &ps) { return solver->addClause_(ps); }
+  bool addAtMostOne(const vec<Lit> &ps) { return solver->addAtMostOne(ps); }
+
+  lbool solveLimited(const vec<Lit> &assumps, bool do_simp = false,
+                     bool turn_off_simp = false);
+  int nSolves() { return solver->solves; }
+  void setConfBudget(int64_t x) { solver->setConfBudget(x); }
+  void budgetOff() { solver->budgetOff(); }
+  void interrupt() { solver->interrupt(); }
+  void clearInterrupt() { solver->clearInterrupt(); }
+
+  void setIncrementalMode() { solver->setIncrementalMode(); }
+  void setDecisionVar(Var v, bool b) { solver->setDecisionVar(v, b); }
+  void setActivity(Var v, double act) { solver->setActivity(v, act); }
+  double getActivity(Var v) { return solver->getActivity(v); }
+  void setPolarity(Var v, bool b) { solver->setPolarity(v, b); }
+  void setInitialPolarity(Var v, bool b) { solver->setInitialPolarity(v, b); }
+  void setBestPhase(Var v, bool b) { solver->setBestPhase(v, b); }
+
+  bool canEliminate() { return simp != NULL && simp->use_simplification; }
+  void setFrozen(Var v, bool b) {
+    if (simp != NULL)
+      simp->setFrozen(v, b);
+  }
+  int nEliminated() { return simp != NULL ? simp->eliminated_vars : 0; }
+  int nSubstituted() { return simp != NULL ? simp->substituted_vars : 0; }
+
+  void exportLearnts(vec<Lit> &out, int nv, unsigned int max_lbd) {
+    solver->exportLearnts(out, nv, max_lbd);
+  }
+
+protected:
+  NSPACE::Solver *solver;
+  NSPACE::SimpSolver *simp; // 'solver' if it eliminates variables.
+};
+
+} // namespace openwbo
+
+#endif
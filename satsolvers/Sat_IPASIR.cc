@@ -0,0 +1,63 @@
+/*!
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "Sat_IPASIR.h"
+
+using namespace openwbo;
+
+// IPASIR does not report a formula that becomes unsatisfiable when a clause is
+// added, the next call finds out.
+bool IPASIRSolver::addClause_(vec<Lit> &ps) {
+  for (int i = 0; i < ps.size(); i++)
+    ipasir->add(solver, toIPASIR(ps[i]));
+  ipasir->add(solver, 0);
+  return true;
+}
+
+lbool IPASIRSolver::solveLimited(const vec<Lit> &assumps, bool do_simp,
+                                 bool turn_off_simp) {
+  for (int i = 0; i < assumps.size(); i++)
+    ipasir->assume(solver, toIPASIR(assumps[i]));
+  int res = ipasir->solve(solver);
+  nbSolves++;
+
+  model.clear();
+  conflict.clear();
+  if (res == 10) {
+    model.growTo(nbVars);
+    for (int v = 0; v < nbVars; v++) {
+      int value = ipasir->val(solver, v + 1);
+      model[v] = value > 0 ? l_True : value < 0 ? l_False : l_Undef;
+    }
+    return l_True;
+  }
+  if (res == 20) {
+    for (int i = 0; i < assumps.size(); i++)
+      if (ipasir->failed(solver, toIPASIR(assumps[i])))
+        conflict.push(~assumps[i]);
+    return l_False;
+  }
+  return l_Undef;
+}
@@ -0,0 +1,79 @@
+/*!
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2017, Ruben Martins, Vasco Manquinho, Ines Lynce
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef Sat_IPASIR_h
+#define Sat_IPASIR_h
+
+#include "../SATSolver.h"
+#include "IPASIR.h"
+
+namespace openwbo {
+
+//=================================================================================================
+// A solver behind the IPASIR functions. Only the polarities and the decision
+// variables reach it, the other hints are dropped.
+class IPASIRSolver : public SATSolver {
+
+public:
+  IPASIRSolver(const IPASIRFunctions *f) {
+    ipasir = f;
+    solver = ipasir->init();
+    nbVars = 0;
+    nbSolves = 0;
+  }
+  ~IPASIRSolver() { ipasir->release(solver); }
+
+  const char *name() { return ipasir->signature(); }
+
+  Var newVar() { return nbVars++; }
+  int nVars() { return nbVars; }
+  bool addClause_(vec<Lit> &ps);
+
+  lbool solveLimited(const vec<Lit> &assumps, bool do_simp = false,
+                     bool turn_off_simp = false);
+  int nSolves() { return nbSolves; }
+  void setConfBudget(int64_t x) { ipasir->set_conflict_limit(solver, x); }
+  void budgetOff() { ipasir->set_conflict_limit(solver, -1); }
+  void interrupt() { ipasir->interrupt(solver, 1); }
+  void clearInterrupt() { ipasir->interrupt(solver, 0); }
+
+  void setDecisionVar(Var v, bool b) { ipasir->set_decision(solver, v + 1, b); }
+  void setPolarity(Var v, bool b) {
+    ipasir->set_phase(solver, b ? -(v + 1) : v + 1);
+  }
+  void setInitialPolarity(Var v, bool b) { setPolarity(v, b); }
+
+protected:
+  static int toIPASIR(Lit l) { return sign(l) ? -(var(l) + 1) : var(l) + 1; }
+
+  const IPASIRFunctions *ipasir;
+  void *solver;
+  int nbVars;
+  int nbSolves;
+};
+
+} // namespace openwbo
+
+#endif
@@ -2,3 +2,4 @@ VERSION    = core
 SOLVERNAME = "Glucose4.1"
 SOLVERDIR  = glucose4.1
 NSPACE     = Glucose
+CFLAGS    += -DINCREMENTAL
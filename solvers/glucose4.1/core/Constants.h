@@ -57,3 +57,6 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 // Constants for restarts
 #define LOWER_BOUND_FOR_BLOCKING_RESTART 10000
 
+// Watchers ahead of the visited one whose clause is prefetched during propagation
+#define PREFETCH_DISTANCE 4
+
@@ -57,6 +57,12 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 using namespace Glucose;
 
+#if defined(__GNUC__)
+#define PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define PREFETCH(addr)
+#endif
+
 
 //=================================================================================================
 // Statistics
@@ -87,6 +93,10 @@ static IntOption opt_lb_lbd_frozen_clause(_cred, "minLBDFrozenClause", "Protect
 static BoolOption opt_chanseok_hack(_cred, "chanseok",
                                     "Use Chanseok Oh strategy for LBD (keep all LBD<=co and remove half of firstreduceDB other learnt clauses", false);
 static IntOption opt_chanseok_limit(_cred, "co", "Chanseok Oh: all learnt clauses with LBD<=co are permanent", 5, IntRange(2, INT32_MAX));
+static BoolOption opt_vivify(_cred, "vivify", "Vivify the learnt clauses with a small LBD after each reduce DB", true);
+static IntOption opt_vivify_lbd(_cred, "vivify-lbd", "The max LBD of the learnt clauses to vivify", 6, IntRange(2, INT32_MAX));
+static DoubleOption opt_vivify_effort(_cred, "vivify-effort", "Propagations spent in vivification, relative to the search since the last one", 0.1,
+                                      DoubleRange(0, false, 1, true));
 
 
 static IntOption opt_lb_size_minimzing_clause(_cm, "minSizeMinimizingClause", "The min size required to minimize clause", 30, IntRange(3, INT32_MAX));
@@ -113,6 +123,18 @@ static IntOption opt_randomize_phase_on_restarts(_cat, "phase-restart",
                                                  "The amount of randomization for the phase at each restart (0=none, 1=first branch, 2=first branch (no bad clauses), 3=first branch (only initial clauses)",
                                                  0, IntRange(0, 3));
 static BoolOption opt_fixed_randomize_phase_on_restarts(_cat, "fix-phas-rest", "Fixes the first 7 levels at random phase", false);
+static IntOption opt_target_phases(_cat, "target-phase",
+                                   "Branch on the phases of the longest conflict-free trail since the last rephasing (0=never, 1=when improving a model without assumptions, 2=always)",
+                                   1, IntRange(0, 2));
+static BoolOption opt_rephase(_cr, "rephase", "Periodically reset the phases (best, original, inverted, random walk)", true);
+static IntOption opt_rephase_int(_cr, "rephase-int", "Conflicts before the first rephasing (the interval grows arithmetically)", 1000,
+                                 IntRange(1, INT32_MAX));
+static IntOption opt_chrono(_cat, "chrono", "Backtrack chronologically when the backjump skips more levels (-1=never, e.g. 100)", -1,
+                           IntRange(-1, INT32_MAX));
+static BoolOption opt_ternary(_cat, "ternary", "Keep both other literals of a ternary clause in its watchers", false);
+static BoolOption opt_prefetch(_cat, "prefetch", "Prefetch the clauses of the next watchers during propagation", true);
+static DoubleOption opt_walk_effort(_cr, "walk-effort", "Flips of a random walk rephasing, relative to the number of original clauses", 1,
+                                    DoubleRange(0, true, HUGE_VAL, false));
 
 static BoolOption opt_adapt(_cat, "adapt", "Adapt dynamically stategies after 100000 conflicts", true);
 
@@ -138,6 +160,9 @@ verbosity(0)
 , coLBDBound (opt_chanseok_limit)
 , lbSizeMinimizingClause(opt_lb_size_minimzing_clause)
 , lbLBDMinimizingClause(opt_lb_lbd_minimzing_clause)
+, vivify(opt_vivify)
+, vivifyLBD(opt_vivify_lbd)
+, vivifyEffort(opt_vivify_effort)
 , var_decay(opt_var_decay)
 , max_var_decay(opt_max_var_decay)
 , clause_decay(opt_clause_decay)
@@ -146,6 +171,13 @@ verbosity(0)
 , ccmin_mode(opt_ccmin_mode)
 , phase_saving(opt_phase_saving)
 , rnd_pol(false)
+, target_phases(opt_target_phases)
+, rephase(opt_rephase)
+, rephase_int(opt_rephase_int)
+, walk_effort(opt_walk_effort)
+, chrono(opt_chrono)
+, ternary(opt_ternary)
+, prefetch(opt_prefetch)
 , rnd_init_act(opt_rnd_init_act)
 , randomizeFirstDescent(false)
 , garbage_frac(opt_garbage_frac)
@@ -173,13 +205,21 @@ verbosity(0)
 , var_inc(1)
 , watches(WatcherDeleted(ca))
 , watchesBin(WatcherDeleted(ca))
+, watchesTern(TernaryWatcherDeleted(ca))
 , unaryWatches(WatcherDeleted(ca))
+, target_assigned(0)
+, best_assigned(0)
+, bestSeeded(false)
+, rephaseConflicts(rephase_int)
 , qhead(0)
 , simpDB_assigns(-1)
 , simpDB_props(0)
 , order_heap(VarOrderLt(activity))
 , progress_estimate(0)
 , remove_satisfied(true)
+, vivifyPending(false)
+, vivifyProps(0)
+, vivifyConflicts(0)
 ,lastLearntClause(CRef_Undef)
 // Resource constraints:
 //
@@ -201,6 +241,8 @@ verbosity(0)
     sumLBD = 0;
     nbclausesbeforereduce = firstReduceDB;
     stats.growTo(coreStatsSize, 0);
+    amoReasonRef = CRef_Undef;
+    amoConflictRef = CRef_Undef;
 }
 
 //-------------------------------------------------------
@@ -222,6 +264,9 @@ Solver::Solver(const Solver &s) :
 , coLBDBound (opt_chanseok_limit)
 , lbSizeMinimizingClause(s.lbSizeMinimizingClause)
 , lbLBDMinimizingClause(s.lbLBDMinimizingClause)
+, vivify(s.vivify)
+, vivifyLBD(s.vivifyLBD)
+, vivifyEffort(s.vivifyEffort)
 , var_decay(s.var_decay)
 , max_var_decay(s.max_var_decay)
 , clause_decay(s.clause_decay)
@@ -230,6 +275,13 @@ Solver::Solver(const Solver &s) :
 , ccmin_mode(s.ccmin_mode)
 , phase_saving(s.phase_saving)
 , rnd_pol(s.rnd_pol)
+, target_phases(s.target_phases)
+, rephase(s.rephase)
+, rephase_int(s.rephase_int)
+, walk_effort(s.walk_effort)
+, chrono(s.chrono)
+, ternary(s.ternary)
+, prefetch(s.prefetch)
 , rnd_init_act(s.rnd_init_act)
 , randomizeFirstDescent(s.randomizeFirstDescent)
 , garbage_frac(s.garbage_frac)
@@ -258,13 +310,21 @@ Solver::Solver(const Solver &s) :
 , var_inc(s.var_inc)
 , watches(WatcherDeleted(ca))
 , watchesBin(WatcherDeleted(ca))
+, watchesTern(TernaryWatcherDeleted(ca))
 , unaryWatches(WatcherDeleted(ca))
+, target_assigned(s.target_assigned)
+, best_assigned(s.best_assigned)
+, bestSeeded(s.bestSeeded)
+, rephaseConflicts(s.rephaseConflicts)
 , qhead(s.qhead)
 , simpDB_assigns(s.simpDB_assigns)
 , simpDB_props(s.simpDB_props)
 , order_heap(VarOrderLt(activity))
 , progress_estimate(s.progress_estimate)
 , remove_satisfied(s.remove_satisfied)
+, vivifyPending(false)
+, vivifyProps(0)
+, vivifyConflicts(0)
 ,lastLearntClause(CRef_Undef)
 // Resource constraints:
 //
@@ -292,14 +352,19 @@ Solver::Solver(const Solver &s) :
     // Copy all search vectors
     s.watches.copyTo(watches);
     s.watchesBin.copyTo(watchesBin);
+    s.watchesTern.copyTo(watchesTern);
     s.unaryWatches.copyTo(unaryWatches);
+    s.sharedWatchSum.memCopyTo(sharedWatchSum);
     s.assigns.memCopyTo(assigns);
     s.vardata.memCopyTo(vardata);
     s.activity.memCopyTo(activity);
     s.seen.memCopyTo(seen);
     s.permDiff.memCopyTo(permDiff);
     s.polarity.memCopyTo(polarity);
-    s.fixed_polarity.memCopyTo(polarity);
+    s.fixed_polarity.memCopyTo(fixed_polarity);
+    s.orig_phase.memCopyTo(orig_phase);
+    s.target_phase.memCopyTo(target_phase);
+    s.best_phase.memCopyTo(best_phase);
     s.decision.memCopyTo(decision);
     s.trail.memCopyTo(trail);
     s.order_heap.copyTo(order_heap);
@@ -311,6 +376,15 @@ Solver::Solver(const Solver &s) :
     s.trailQueue.copyTo(trailQueue);
     s.forceUNSAT.copyTo(forceUNSAT);
     s.stats.copyTo(stats);
+
+    s.amoLits.memCopyTo(amoLits);
+    s.amoStart.memCopyTo(amoStart);
+    amoWatches.growTo(s.amoWatches.size());
+    for(int i = 0; i < s.amoWatches.size(); i++)
+        s.amoWatches[i].memCopyTo(amoWatches[i]);
+    s.amoImplier.memCopyTo(amoImplier);
+    amoReasonRef = s.amoReasonRef;
+    amoConflictRef = s.amoConflictRef;
 }
 
 
@@ -377,6 +451,8 @@ Var Solver::newVar(bool sign, bool dvar) {
     watches.init(mkLit(v, true));
     watchesBin.init(mkLit(v, false));
     watchesBin.init(mkLit(v, true));
+    watchesTern.init(mkLit(v, false));
+    watchesTern.init(mkLit(v, true));
     unaryWatches.init(mkLit(v, false));
     unaryWatches.init(mkLit(v, true));
     assigns.push(l_Undef);
@@ -386,7 +462,13 @@ Var Solver::newVar(bool sign, bool dvar) {
     permDiff.push(0);
     polarity.push(sign);
     fixed_polarity.push(false);
+    orig_phase.push(sign);
+    target_phase.push(2);
+    best_phase.push(sign);
     forceUNSAT.push(0);
+    amoWatches.push();
+    amoWatches.push();
+    amoImplier.push(lit_Undef);
     decision.push();
     trail.capacity(v + 1);
     setDecisionVar(v, dvar);
@@ -396,7 +478,8 @@ Var Solver::newVar(bool sign, bool dvar) {
 
 bool Solver::addClause_(vec <Lit> &ps) {
 
-    assert(decisionLevel() == 0);
+    // The assumption levels kept by the last call to solve are only
+    // undone if the clause is unit or false under them (see below).
     if(!ok) return false;
 
     // Check if clause is satisfied and remove false/duplicate literals:
@@ -416,12 +499,36 @@ bool Solver::addClause_(vec <Lit> &ps) {
     }
 
     for(i = j = 0, p = lit_Undef; i < ps.size(); i++)
-        if(value(ps[i]) == l_True || ps[i] == ~p)
+        if(rootValue(ps[i]) == l_True || ps[i] == ~p)
             return true;
-        else if(value(ps[i]) != l_False && ps[i] != p)
+        else if(rootValue(ps[i]) != l_False && ps[i] != p)
             ps[j++] = p = ps[i];
     ps.shrink(i - j);
 
+    // Watch two literals that are not false on the kept trail, a clause that
+    // is unit or false on it only undoes the levels of its false literals
+    while(decisionLevel() > 0) {
+        int k = 0;
+        for(i = 0; i < ps.size() && k < 2; i++)
+            if(value(ps[i]) != l_False) {
+                Lit tmp = ps[k];
+                ps[k++] = ps[i];
+                ps[i] = tmp;
+            }
+        if(k == 2) break;
+        if(ps.size() < 2) {
+            cancelUntil(0);
+            break;
+        }
+        int first = 0, second = 0; // highest levels of the false literals
+        for(i = k; i < ps.size(); i++) {
+            int l = level(var(ps[i]));
+            if(l > first) second = first, first = l;
+            else if(l > second) second = l;
+        }
+        cancelUntil((k == 1 ? first : second) - 1);
+    }
+
     if(flag && (certifiedUNSAT)) {
         if(vbyte) {
             write_char('a');
@@ -462,6 +569,80 @@ bool Solver::addClause_(vec <Lit> &ps) {
 }
 
 
+// Adds the constraint that at most one literal of 'ps' is true. A literal occurring twice must be
+// false; a pair of complementary literals already contains the true literal, so all the other
+// literals must be false. Constraints over two literals are added as binary clauses.
+//
+
+bool Solver::addAtMostOne(const vec <Lit> &ps) {
+    cancelUntil(0);
+    if(!ok) return false;
+
+    vec <Lit> lits;
+    ps.copyTo(lits);
+    sort(lits);
+
+    // literals of the same variable are adjacent after sorting
+    vec <Lit> units;
+    int nTrue = 0;
+    int i, j, k;
+    for(i = j = 0; i < lits.size(); i = k) {
+        int pos = 0, neg = 0;
+        for(k = i; k < lits.size() && var(lits[k]) == var(lits[i]); k++)
+            sign(lits[k]) ? neg++ : pos++;
+        if(pos > 1) units.push(~mkLit(var(lits[i]), false));
+        if(neg > 1) units.push(~mkLit(var(lits[i]), true));
+        if(pos > 0 && neg > 0)
+            nTrue++;
+        else if(pos + neg == 1 && value(lits[i]) == l_True)
+            nTrue++;
+        else if(pos + neg == 1 && value(lits[i]) == l_Undef)
+            lits[j++] = lits[i];
+    }
+    lits.shrink(i - j);
+
+    if(nTrue > 1)
+        return ok = false;
+    if(nTrue == 1) {
+        for(i = 0; i < lits.size(); i++) units.push(~lits[i]);
+        lits.clear();
+    }
+    for(i = 0; i < units.size(); i++) {
+        if(value(units[i]) == l_False) return ok = false;
+        if(value(units[i]) == l_Undef) uncheckedEnqueue(units[i]);
+    }
+    if(units.size() > 0 && propagate() != CRef_Undef)
+        return ok = false;
+
+    // literals falsified by the units do not constrain anything
+    for(i = j = 0; i < lits.size(); i++)
+        if(value(lits[i]) != l_False)
+            lits[j++] = lits[i];
+    lits.shrink(i - j);
+
+    if(lits.size() < 2)
+        return true;
+    if(lits.size() == 2)
+        return addClause(~lits[0], ~lits[1]);
+
+    if(amoReasonRef == CRef_Undef) {
+        vec <Lit> scratch;
+        scratch.push(lits[0]);
+        scratch.push(lits[1]);
+        amoReasonRef = ca.alloc(scratch, false);
+        amoConflictRef = ca.alloc(scratch, false);
+        amoStart.push(0);
+    }
+    int index = amoStart.size() - 1;
+    for(i = 0; i < lits.size(); i++) {
+        amoLits.push(lits[i]);
+        amoWatches[toInt(lits[i])].push(index);
+    }
+    amoStart.push(amoLits.size());
+    return true;
+}
+
+
 void Solver::attachClause(CRef cr) {
     const Clause &c = ca[cr];
 
@@ -469,6 +650,9 @@ void Solver::attachClause(CRef cr) {
     if(c.size() == 2) {
         watchesBin[~c[0]].push(Watcher(cr, c[1]));
         watchesBin[~c[1]].push(Watcher(cr, c[0]));
+    } else if(isTernary(c)) {
+        watchesTern[~c[0]].push(TernaryWatcher(cr, c[1], c[2]));
+        watchesTern[~c[1]].push(TernaryWatcher(cr, c[0], c[2]));
     } else {
         watches[~c[0]].push(Watcher(cr, c[1]));
         watches[~c[1]].push(Watcher(cr, c[0]));
@@ -500,6 +684,14 @@ void Solver::detachClause(CRef cr, bool strict) {
             watchesBin.smudge(~c[0]);
             watchesBin.smudge(~c[1]);
         }
+    } else if(isTernary(c)) {
+        if(strict) {
+            remove(watchesTern[~c[0]], TernaryWatcher(cr, c[1], c[2]));
+            remove(watchesTern[~c[1]], TernaryWatcher(cr, c[0], c[2]));
+        } else {
+            watchesTern.smudge(~c[0]);
+            watchesTern.smudge(~c[1]);
+        }
     } else {
         if(strict) {
             remove(watches[~c[0]], Watcher(cr, c[1]));
@@ -661,6 +853,11 @@ void Solver::cancelUntil(int level) {
     if(decisionLevel() > level) {
         for(int c = trail.size() - 1; c >= trail_lim[level]; c--) {
             Var x = var(trail[c]);
+            // Out of order literal (chronological backtracking), it stays on the trail
+            if(vardata[x].level <= level) {
+                cancel_kept.push(trail[c]);
+                continue;
+            }
             assigns[x] = l_Undef;
             if(phase_saving > 1 || ((phase_saving == 1) && c > trail_lim.last())) {
                 if (!fixed_polarity[x])
@@ -671,6 +868,9 @@ void Solver::cancelUntil(int level) {
         qhead = trail_lim[level];
         trail.shrink(trail.size() - trail_lim[level]);
         trail_lim.shrink(trail_lim.size() - level);
+        for(int i = cancel_kept.size() - 1; i >= 0; i--)
+            trail.push_(cancel_kept[i]);
+        cancel_kept.clear();
     }
 }
 
@@ -707,14 +907,158 @@ Lit Solver::pickBranchLit() {
 
     if(next == var_Undef) return lit_Undef;
 
+    bool phase = polarity[next];
+    // The target phases pay off when looking for a better model, they slow down refutations (cores
+    // under assumptions, unsatisfiable first calls)
+    if((target_phases == 2 || (target_phases == 1 && nbSatCalls > 0 && assumptions.size() == 0)) && !fixed_polarity[next] &&
+       target_phase[next] != 2)
+        phase = target_phase[next];
+
     if(forceUnsatOnNewDescent && newDescent) {
         if(forceUNSAT[next] != 0)
             return mkLit(next, forceUNSAT[next] < 0);
-        return mkLit(next, polarity[next]);
+        return mkLit(next, phase);
+
+    }
+
+    return mkLit(next, rnd_pol ? drand(random_seed) < 0.5 : phase);
+}
+
+
+void Solver::savePhases(vec<char>& phases, int end) {
+    for(int i = 0; i < end; i++)
+        phases[var(trail[i])] = sign(trail[i]);
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  rephasePolarities : ()  ->  [void]
+|
+|  Description:
+|    Resets the saved polarities, in turn to the best trail, the original polarities, the best trail,
+|    the inverted original polarities, the best trail and a random walk. The target trail starts
+|    over. Variables with a fixed polarity keep it.
+|________________________________________________________________________________________________@*/
+void Solver::rephasePolarities() {
+    static const char schedule[] = "BOBIBW";
+    char kind = schedule[stats[nbRephases]++ % (sizeof(schedule) - 1)];
+
+    if(kind == 'W')
+        walkPhases();
+    else
+        for(Var v = 0; v < nVars(); v++) {
+            if(fixed_polarity[v]) continue;
+            if(kind == 'B') polarity[v] = best_phase[v];
+            else if(kind == 'O') polarity[v] = orig_phase[v];
+            else polarity[v] = !orig_phase[v];
+        }
+
+    // A model (or the seed of the caller) stays the best trail until it was tried
+    if(kind == 'B') best_assigned = 0;
+    for(Var v = 0; v < nVars(); v++)
+        target_phase[v] = 2;
+    target_assigned = 0;
+    rephaseConflicts = conflicts + (uint64_t) rephase_int * (stats[nbRephases] + 1);
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  walkPhases : ()  ->  [void]
+|
+|  Description:
+|    WalkSAT over the original clauses, started from the saved polarities. The variables assigned
+|    at the current level (units and assumptions) keep their value. The polarities are set to the
+|    assignment with the fewest falsified clauses. Native at-most-one constraints are left to the
+|    search.
+|________________________________________________________________________________________________@*/
+void Solver::walkPhases() {
+    vec<char> val;
+    polarity.copyTo(val);
+    for(Var v = 0; v < nVars(); v++)
+        if(value(v) != l_Undef) val[v] = value(v) == l_False;
+
+    // Clauses not satisfied by the fixed variables, with their number of true literals
+    vec<CRef> cs;
+    vec<int> nbTrue;
+    vec<vec<int> > occurs(2 * nVars());
+    for(int i = 0; i < clauses.size(); i++) {
+        Clause& c = ca[clauses[i]];
+        if(satisfied(c)) continue;
+        int t = 0;
+        for(int j = 0; j < c.size(); j++) {
+            occurs[toInt(c[j])].push(cs.size());
+            if(val[var(c[j])] == sign(c[j])) t++;
+        }
+        cs.push(clauses[i]);
+        nbTrue.push(t);
+    }
+    vec<int> falsified, position(cs.size(), -1);
+    for(int i = 0; i < cs.size(); i++)
+        if(nbTrue[i] == 0) {
+            position[i] = falsified.size();
+            falsified.push(i);
+        }
+
+    // Flips since the best assignment, undone at the end
+    vec<Var> flipped;
+    int best = falsified.size();
+    int64_t flips = (int64_t) (walk_effort * cs.size());
+    for(; flips > 0 && falsified.size() > 0; flips--) {
+        Clause& c = ca[cs[falsified[irand(random_seed, falsified.size())]]];
+        Lit pick = lit_Undef;
+        int minBreak = INT32_MAX, nbFree = 0;
+        for(int j = 0; j < c.size() && minBreak > 0; j++) {
+            if(value(c[j]) != l_Undef) continue;
+            nbFree++;
+            int nbBreak = 0;
+            vec<int>& occ = occurs[toInt(~c[j])];
+            for(int k = 0; k < occ.size(); k++)
+                if(nbTrue[occ[k]] == 1) nbBreak++;
+            if(nbBreak < minBreak) {
+                minBreak = nbBreak;
+                pick = c[j];
+            }
+        }
+        if(pick == lit_Undef) continue;
+        // Noise: a random literal unless some flip breaks nothing
+        if(minBreak > 0 && drand(random_seed) < 0.5) {
+            int r = irand(random_seed, nbFree);
+            for(int j = 0; j < c.size(); j++)
+                if(value(c[j]) == l_Undef && r-- == 0) {
+                    pick = c[j];
+                    break;
+                }
+        }
 
+        val[var(pick)] = sign(pick);
+        flipped.push(var(pick));
+        vec<int>& made = occurs[toInt(pick)];
+        for(int k = 0; k < made.size(); k++)
+            if(nbTrue[made[k]]++ == 0) {
+                int p = position[made[k]];
+                falsified[p] = falsified.last();
+                position[falsified[p]] = p;
+                falsified.pop();
+                position[made[k]] = -1;
+            }
+        vec<int>& broken = occurs[toInt(~pick)];
+        for(int k = 0; k < broken.size(); k++)
+            if(--nbTrue[broken[k]] == 0) {
+                position[broken[k]] = falsified.size();
+                falsified.push(broken[k]);
+            }
+        if(falsified.size() < best) {
+            best = falsified.size();
+            flipped.clear();
+        }
     }
+    for(int i = flipped.size() - 1; i >= 0; i--)
+        val[flipped[i]] = !val[flipped[i]];
 
-    return next == var_Undef ? lit_Undef : mkLit(next, rnd_pol ? drand(random_seed) < 0.5 : polarity[next]);
+    for(Var v = 0; v < nVars(); v++)
+        if(!fixed_polarity[v]) polarity[v] = val[v];
 }
 
 
@@ -735,7 +1079,7 @@ Lit Solver::pickBranchLit() {
 |        rest of literals. There may be others from the same level though.
 |  
 |________________________________________________________________________________________________@*/
-void Solver::analyze(CRef confl, vec <Lit> &out_learnt, vec <Lit> &selectors, int &out_btlevel, unsigned int &lbd, unsigned int &szWithoutSelectors) {
+void Solver::analyze(CRef confl, int confl_level, vec <Lit> &out_learnt, vec <Lit> &selectors, int &out_btlevel, unsigned int &lbd, unsigned int &szWithoutSelectors) {
     int pathC = 0;
     Lit p = lit_Undef;
 
@@ -747,19 +1091,11 @@ void Solver::analyze(CRef confl, vec <Lit> &out_learnt, vec <Lit> &selectors, in
     do {
         assert(confl != CRef_Undef); // (otherwise should be UIP)
         Clause &c = ca[confl];
-        // Special case for binary clauses
-        // The first one has to be SAT
-        if(p != lit_Undef && c.size() == 2 && value(c[0]) == l_False) {
-
-            assert(value(c[1]) == l_True);
-            Lit tmp = c[0];
-            c[0] = c[1], c[1] = tmp;
-        }
 
         if(c.learnt()) {
             parallelImportClauseDuringConflictAnalysis(c, confl);
             claBumpActivity(c);
-        } else { // original clause
+        } else if(!c.shared()) { // original clause
             if(!c.getSeen()) {
                 stats[originalClausesSeen]++;
                 c.setSeen(true);
@@ -787,8 +1123,10 @@ void Solver::analyze(CRef confl, vec <Lit> &out_learnt, vec <Lit> &selectors, in
         }
 
 
-        for(int j = (p == lit_Undef) ? 0 : 1; j < c.size(); j++) {
+        // The implied literal p is c[0], except in binary, ternary and shared clauses
+        for(int j = 0; j < c.size(); j++) {
             Lit q = c[j];
+            if(q == p) continue;
 
             if(!seen[var(q)]) {
                 if(level(var(q)) == 0) {
@@ -801,10 +1139,10 @@ void Solver::analyze(CRef confl, vec <Lit> &out_learnt, vec <Lit> &selectors, in
                     bumpForceUNSAT(~q); // Negation because q is false here
 
                     seen[var(q)] = 1;
-                    if(level(var(q)) >= decisionLevel()) {
+                    if(level(var(q)) >= confl_level) {
                         pathC++;
                         // UPDATEVARACTIVITY trick (see competition'09 companion paper)
-                        if(!isSelector(var(q)) && (reason(var(q)) != CRef_Undef) && ca[reason(var(q))].learnt())
+                        if(!isSelector(var(q)) && (reason(var(q)) != CRef_Undef) && (reason(var(q)) != CRef_AMO) && ca[reason(var(q))].learnt())
                             lastDecisionLevel.push(q);
                     } else {
                         if(isSelector(var(q))) {
@@ -817,11 +1155,13 @@ void Solver::analyze(CRef confl, vec <Lit> &out_learnt, vec <Lit> &selectors, in
             } //else stats[sumResSeen]++;
         }
 
-        // Select next clause to look at:
-        while (!seen[var(trail[index--])]);
-        p = trail[index + 1];
+        // Select next clause to look at (lower levels may be interleaved with chronological backtracking):
+        do {
+            while(!seen[var(trail[index--])]);
+            p = trail[index + 1];
+        } while(level(var(p)) < confl_level);
         //stats[sumRes]++;
-        confl = reason(var(p));
+        confl = reasonClause(var(p));
         seen[var(p)] = 0;
         pathC--;
 
@@ -852,9 +1192,9 @@ void Solver::analyze(CRef confl, vec <Lit> &out_learnt, vec <Lit> &selectors, in
             if(reason(x) == CRef_Undef)
                 out_learnt[j++] = out_learnt[i];
             else {
-                Clause &c = ca[reason(var(out_learnt[i]))];
+                Clause &c = ca[reasonClause(var(out_learnt[i]))];
                 // Thanks to Siert Wieringa for this bug fix!
-                for(int k = ((c.size() == 2) ? 0 : 1); k < c.size(); k++)
+                for(int k = ((c.size() == 2 || c.shared() || isTernary(c)) ? 0 : 1); k < c.size(); k++)
                     if(!seen[var(c[k])] && level(var(c[k])) > 0) {
                         out_learnt[j++] = out_learnt[i];
                         break;
@@ -931,17 +1271,14 @@ bool Solver::litRedundant(Lit p, uint32_t abstract_levels) {
     analyze_stack.push(p);
     int top = analyze_toclear.size();
     while(analyze_stack.size() > 0) {
-        assert(reason(var(analyze_stack.last())) != CRef_Undef);
-        Clause &c = ca[reason(var(analyze_stack.last()))];
+        Var x = var(analyze_stack.last());
+        assert(reason(x) != CRef_Undef);
+        Clause &c = ca[reasonClause(x)];
         analyze_stack.pop(); //
-        if(c.size() == 2 && value(c[0]) == l_False) {
-            assert(value(c[1]) == l_True);
-            Lit tmp = c[0];
-            c[0] = c[1], c[1] = tmp;
-        }
 
-        for(int i = 1; i < c.size(); i++) {
+        for(int i = 0; i < c.size(); i++) {
             Lit p = c[i];
+            if(var(p) == x) continue;
             if(!seen[var(p)]) {
                 if(level(var(p)) > 0) {
                     if(reason(var(p)) != CRef_Undef && (abstractLevel(var(p)) & abstract_levels) != 0) {
@@ -976,7 +1313,7 @@ void Solver::analyzeFinal(Lit p, vec <Lit> &out_conflict) {
     out_conflict.clear();
     out_conflict.push(p);
 
-    if(decisionLevel() == 0)
+    if(decisionLevel() == 0 || level(var(p)) == 0)
         return;
 
     seen[var(p)] = 1;
@@ -988,11 +1325,11 @@ void Solver::analyzeFinal(Lit p, vec <Lit> &out_conflict) {
                 assert(level(x) > 0);
                 out_conflict.push(~trail[i]);
             } else {
-                Clause &c = ca[reason(x)];
+                Clause &c = ca[reasonClause(x)];
                 //                for (int j = 1; j < c.size(); j++) Minisat (glucose 2.0) loop
                 // Bug in case of assumptions due to special data structures for Binary.
                 // Many thanks to Sam Bayless (sbayless@cs.ubc.ca) for discover this bug.
-                for(int j = ((c.size() == 2) ? 0 : 1); j < c.size(); j++)
+                for(int j = ((c.size() == 2 || c.shared() || isTernary(c)) ? 0 : 1); j < c.size(); j++)
                     if(level(var(c[j])) > 0)
                         seen[var(c[j])] = 1;
             }
@@ -1005,10 +1342,71 @@ void Solver::analyzeFinal(Lit p, vec <Lit> &out_conflict) {
 }
 
 
+/*_________________________________________________________________________________________________
+|
+|  conflictLevel : (confl : CRef) (single : bool&)  ->  [int]
+|
+|  Description:
+|    With chronological backtracking the trail is out of order and a conflict may be found below
+|    the decision level. Returns the highest level of the literals of 'confl' and moves one of them
+|    to c[0]. 'single' is set if it is the only literal at this level, the clause is then unit
+|    below it and c[1] is a literal of the next highest level. The moved literals stay watched.
+|________________________________________________________________________________________________@*/
+int Solver::conflictLevel(CRef confl, bool& single) {
+    Clause &c = ca[confl];
+    single = false;
+    if(level(var(c[0])) == decisionLevel() && level(var(c[1])) == decisionLevel())
+        return decisionLevel();
+
+    int max_i = 0;
+    single = true;
+    for(int i = 1; i < c.size(); i++) {
+        if(level(var(c[i])) > level(var(c[max_i]))) {
+            max_i = i;
+            single = true;
+        } else if(level(var(c[i])) == level(var(c[max_i])))
+            single = false;
+    }
+    moveWatch(confl, 0, max_i);
+
+    if(single) {
+        int next_i = 1;
+        for(int i = 2; i < c.size(); i++)
+            if(level(var(c[i])) > level(var(c[next_i])))
+                next_i = i;
+        moveWatch(confl, 1, next_i);
+    }
+    return level(var(c[0]));
+}
+
+
+void Solver::moveWatch(CRef cr, int w, int i) {
+    if(i == w) return;
+    Clause &c = ca[cr];
+    Lit old = c[w];
+    c[w] = c[i];
+    c[i] = old;
+    // Both watches are only swapped, and the conflict of an at-most-one constraint is not attached
+    if(i < 2 || cr == amoConflictRef) return;
+    if(isTernary(c)) {
+        remove(watchesTern[~old], TernaryWatcher(cr, c[1 - w], c[2]));
+        watchesTern[~c[w]].push(TernaryWatcher(cr, c[1 - w], c[2]));
+        return;
+    }
+    remove(watches[~old], Watcher(cr, c[1 - w]));
+    watches[~c[w]].push(Watcher(cr, c[1 - w]));
+}
+
+
 void Solver::uncheckedEnqueue(Lit p, CRef from) {
+    uncheckedEnqueue(p, decisionLevel(), from);
+}
+
+
+void Solver::uncheckedEnqueue(Lit p, int level, CRef from) {
     assert(value(p) == l_Undef);
     assigns[var(p)] = lbool(!sign(p));
-    vardata[var(p)] = mkVarData(from, decisionLevel());
+    vardata[var(p)] = mkVarData(from, level);
     trail.push_(p);
 }
 
@@ -1035,9 +1433,11 @@ CRef Solver::propagate() {
     int num_props = 0;
     watches.cleanAll();
     watchesBin.cleanAll();
+    watchesTern.cleanAll();
     unaryWatches.cleanAll();
     while(qhead < trail.size()) {
         Lit p = trail[qhead++]; // 'p' is enqueued fact to propagate.
+        int currLevel = level(var(p)); // Below the decision level after chronological backtracking
         vec <Watcher> &ws = watches[p];
         Watcher *i, *j, *end;
         num_props++;
@@ -1054,12 +1454,79 @@ CRef Solver::propagate() {
             }
 
             if(value(imp) == l_Undef) {
-                uncheckedEnqueue(imp, wbin[k].cref);
+                uncheckedEnqueue(imp, currLevel, wbin[k].cref);
+            }
+        }
+
+        // Then the ternary clauses, which are only read when their watch moves
+        vec <TernaryWatcher> &wtern = watchesTern[p];
+        TernaryWatcher *ti, *tj, *tend;
+        for(ti = tj = (TernaryWatcher *) wtern, tend = ti + wtern.size(); ti != tend;) {
+            Lit other1 = ti->other1, other2 = ti->other2;
+            lbool val1 = value(other1);
+            if(val1 == l_True) {
+                *tj++ = *ti++;
+                continue;
+            }
+            lbool val2 = value(other2);
+            if(val2 == l_True) {
+                *tj++ = *ti++;
+                continue;
+            }
+            if(val1 == l_False && val2 == l_False) {
+                confl = ti->cref;
+                qhead = trail.size();
+                while(ti < tend)
+                    *tj++ = *ti++;
+                break;
+            }
+            if(val1 == l_False && level(var(other1)) <= currLevel) {
+                uncheckedEnqueue(other2, currLevel, ti->cref);
+                *tj++ = *ti++;
+                continue;
+            }
+            if(val2 == l_False && level(var(other2)) <= currLevel) {
+                uncheckedEnqueue(other1, currLevel, ti->cref);
+                *tj++ = *ti++;
+                continue;
+            }
+
+            // Both other literals are unassigned, the watch moves to the third one. Or the clause
+            // propagates at the higher level of a false literal, which must be watched instead.
+            CRef cr = ti->cref;
+            Clause &c = ca[cr];
+            Lit false_lit = ~p;
+            if(c[0] == false_lit)
+                c[0] = c[1], c[1] = false_lit;
+            ti++;
+            c[1] = c[2];
+            c[2] = false_lit;
+            watchesTern[~c[1]].push(TernaryWatcher(cr, c[0], c[2]));
+            if(value(c[1]) == l_False) {
+                assert(value(c[0]) == l_Undef);
+                uncheckedEnqueue(c[0], level(var(c[1])), cr);
+            }
+        }
+        wtern.shrink(ti - tj);
+        if(confl != CRef_Undef)
+            break;
+
+        // Then the at-most-one constraints
+        if(amoWatches[toInt(p)].size() > 0) {
+            CRef cr = propagateAtMostOne(p);
+            if(cr != CRef_Undef) {
+                qhead = trail.size();
+                return cr;
             }
         }
 
         // Now propagate other 2-watched clauses
         for(i = j = (Watcher *) ws, end = i + ws.size(); i != end;) {
+            // Fetch the clause of a later watcher while this one is visited (checking its blocker
+            // first costs more than the useless fetches)
+            if(prefetch && end - i > PREFETCH_DISTANCE)
+                PREFETCH(ca.lea(i[PREFETCH_DISTANCE].cref));
+
             // Try to avoid inspecting the clause:
             Lit blocker = i->blocker;
             if(value(blocker) == l_True) {
@@ -1072,6 +1539,35 @@ CRef Solver::propagate() {
             Clause &c = ca[cr];
             assert(!c.getOneWatched());
             Lit false_lit = ~p;
+            if(c.shared()) {
+                // Shared clauses are read-only: the other watch is recovered from the xor of both
+                // watches instead of being kept in c[0]
+                uint32_t &sum = sharedWatchSum[c.sharedIndex()];
+                Lit first = toLit(sum ^ toInt(false_lit));
+                Watcher w = Watcher(cr, first);
+                i++;
+                if(first != blocker && value(first) == l_True) {
+                    *j++ = w;
+                    continue;
+                }
+                int k = 0;
+                while(k < c.size() && (c[k] == false_lit || c[k] == first || value(c[k]) == l_False))
+                    k++;
+                if(k < c.size()) {
+                    sum = toInt(first) ^ toInt(c[k]);
+                    watches[~c[k]].push(w);
+                    continue;
+                }
+                *j++ = w;
+                if(value(first) == l_False) {
+                    confl = cr;
+                    qhead = trail.size();
+                    while(i < end)
+                        *j++ = *i++;
+                } else
+                    uncheckedEnqueue(first, cr);
+                continue;
+            }
             if(c[0] == false_lit)
                 c[0] = c[1], c[1] = false_lit;
             assert(c[1] == false_lit);
@@ -1131,9 +1627,24 @@ CRef Solver::propagate() {
                 while(i < end)
                     *j++ = *i++;
             } else {
-                uncheckedEnqueue(first, cr);
-
-
+                if(currLevel < decisionLevel()) {
+                    // The clause propagates at the highest level of its false literals, which must
+                    // stay watched when backtracking below it
+                    int max_k = 1, lvl = currLevel;
+                    for(int k = 2; k < c.size(); k++)
+                        if(level(var(c[k])) > lvl) {
+                            lvl = level(var(c[k]));
+                            max_k = k;
+                        }
+                    if(max_k != 1) {
+                        c[1] = c[max_k];
+                        c[max_k] = false_lit;
+                        j--;
+                        watches[~c[1]].push(w);
+                    }
+                    uncheckedEnqueue(first, lvl, cr);
+                } else
+                    uncheckedEnqueue(first, cr);
             }
             NextClause:;
         }
@@ -1155,6 +1666,36 @@ CRef Solver::propagate() {
 }
 
 
+/*_________________________________________________________________________________________________
+|
+|  propagateAtMostOne : [Lit]  ->  [Clause*]
+|
+|  Description:
+|    Falsifies the other literals of the at-most-one constraints containing the true literal p.
+|    If one of them is already true, the binary clause of the conflict is returned,
+|    otherwise CRef_Undef.
+|________________________________________________________________________________________________@*/
+CRef Solver::propagateAtMostOne(Lit p) {
+    vec <int> &ws = amoWatches[toInt(p)];
+    for(int k = 0; k < ws.size(); k++) {
+        for(int i = amoStart[ws[k]]; i < amoStart[ws[k] + 1]; i++) {
+            Lit q = amoLits[i];
+            if(q == p || value(q) == l_False)
+                continue;
+            if(value(q) == l_True) {
+                Clause &c = ca[amoConflictRef];
+                c[0] = ~q;
+                c[1] = ~p;
+                return amoConflictRef;
+            }
+            amoImplier[var(q)] = p;
+            uncheckedEnqueue(~q, level(var(p)), CRef_AMO);
+        }
+    }
+    return CRef_Undef;
+}
+
+
 /*_________________________________________________________________________________________________
 |
 |  propagateUnaryWatches : [Lit]  ->  [Clause*]
@@ -1294,7 +1835,7 @@ void Solver::removeSatisfied(vec <CRef> &cs) {
         Clause &c = ca[cs[i]];
 
 
-        if(satisfied(c)) if(c.getOneWatched())
+        if(!c.shared() && satisfied(c)) if(c.getOneWatched())
             removeClause(cs[i], true);
         else
             removeClause(cs[i]);
@@ -1305,6 +1846,113 @@ void Solver::removeSatisfied(vec <CRef> &cs) {
 }
 
 
+/*_________________________________________________________________________________________________
+|
+|  vivifyLearnts : ()  ->  [void]
+|
+|  Description:
+|    Shortens the learnt clauses with a small LBD that were never vivified, best first. The negation
+|    of the literals of a clause is propagated one literal at a time: a literal that becomes false
+|    is removed, and the clause is cut after a literal that becomes true or a conflict. The round
+|    stops when it spent 'vivifyEffort' times the propagations of the search since the last one.
+|    Must be called at level 0.
+|________________________________________________________________________________________________@*/
+struct vivify_lt {
+    ClauseAllocator &ca;
+
+    vivify_lt(ClauseAllocator &ca_) : ca(ca_) {
+    }
+
+    bool operator()(CRef x, CRef y) {
+        if(ca[x].lbd() != ca[y].lbd()) return ca[x].lbd() < ca[y].lbd();
+        return ca[x].size() < ca[y].size();
+    }
+};
+
+
+void Solver::vivifyLearnts() {
+    assert(decisionLevel() == 0);
+    vivifyPending = false;
+    // The shortened clauses are not written to the proof
+    if(!ok || certifiedUNSAT) return;
+    if(propagate() != CRef_Undef) {
+        ok = false;
+        return;
+    }
+
+    uint64_t limit = propagations + (uint64_t) (vivifyEffort * (propagations - vivifyProps));
+    vec <CRef> candidates;
+    for(int i = 0; i < learnts.size(); i++) {
+        Clause &c = ca[learnts[i]];
+        if(!c.getVivified() && c.size() > 2 && c.lbd() <= vivifyLBD)
+            candidates.push(learnts[i]);
+    }
+    sort(candidates, vivify_lt(ca));
+    stats[nbVivifyRounds]++;
+
+    // The decisions made here must not change the saved phases
+    int phase_saving_search = phase_saving;
+    phase_saving = 0;
+    bool units = false;
+    vec <Lit> lits;
+    for(int i = 0; i < candidates.size() && propagations < limit && ok; i++) {
+        CRef cr = candidates[i];
+        Clause &c = ca[cr];
+        if(c.mark() || satisfied(c) || locked(c)) continue;
+        c.setVivified(true);
+        if(!vivifyClause(cr, lits)) continue;
+
+        stats[nbVivifiedClauses]++;
+        stats[nbVivifiedLiterals] += c.size() - lits.size();
+        assert(lits.size() > 0);
+        if(lits.size() == 1) {
+            removeClause(cr);
+            units = true;
+            uncheckedEnqueue(lits[0]);
+            if(propagate() != CRef_Undef) ok = false;
+        } else {
+            detachClause(cr, true);
+            for(int k = 0; k < lits.size(); k++) c[k] = lits[k];
+            c.shrink(c.size() - lits.size());
+            if(c.lbd() > (unsigned int) c.size()) c.setLBD(c.size());
+            attachClause(cr);
+        }
+    }
+    phase_saving = phase_saving_search;
+
+    if(units) {
+        int j = 0;
+        for(int i = 0; i < learnts.size(); i++)
+            if(!ca[learnts[i]].mark()) learnts[j++] = learnts[i];
+        learnts.shrink(learnts.size() - j);
+    }
+    vivifyProps = propagations;
+    vivifyConflicts = conflicts;
+    checkGarbage();
+}
+
+
+bool Solver::vivifyClause(CRef cr, vec <Lit> &out_lits) {
+    // (propagate reorders the literals of the clause while it is still watched)
+    vec <Lit> lits;
+    const Clause &c = ca[cr];
+    for(int i = 0; i < c.size(); i++) lits.push(c[i]);
+
+    out_lits.clear();
+    for(int i = 0; i < lits.size(); i++) {
+        Lit p = lits[i];
+        if(value(p) == l_False) continue; // implied by the previous literals
+        out_lits.push(p);
+        if(value(p) == l_True) break;     // the clause holds without the next literals
+        newDecisionLevel();
+        uncheckedEnqueue(~p);
+        if(propagate() != CRef_Undef) break;
+    }
+    cancelUntil(0);
+    return out_lits.size() < lits.size();
+}
+
+
 void Solver::rebuildOrderHeap() {
     vec <Var> vs;
     for(Var v = 0; v < nVars(); v++)
@@ -1518,6 +2166,36 @@ lbool Solver::search(int nof_conflicts) {
                 return l_Undef;
             }
 
+            int confl_level = decisionLevel();
+            if(chronoEnabled()) {
+                bool single;
+                confl_level = conflictLevel(confl, single);
+                if(confl_level == 0)
+                    return l_False;
+                if(single) {
+                    // A missed implication: the clause propagates c[0] below the conflict level
+                    Clause &c = ca[confl];
+                    int lvl = level(var(c[1]));
+                    cancelUntil(confl_level - 1);
+                    if(confl == amoConflictRef) {
+                        amoImplier[var(c[0])] = ~c[1];
+                        uncheckedEnqueue(c[0], lvl, CRef_AMO);
+                    } else
+                        uncheckedEnqueue(c[0], lvl, confl);
+                    continue;
+                }
+            }
+
+            // The trail below the conflict level is conflict-free
+            if(target_phases && trail_lim[confl_level - 1] > target_assigned) {
+                target_assigned = trail_lim[confl_level - 1];
+                savePhases(target_phase, target_assigned);
+            }
+            if(rephase && trail_lim[confl_level - 1] > best_assigned) {
+                best_assigned = trail_lim[confl_level - 1];
+                savePhases(best_phase, best_assigned);
+            }
+
             trailQueue.push(trail.size());
             // BLOCK RESTART (CP 2012 paper)
             if(conflictsRestarts > LOWER_BOUND_FOR_BLOCKING_RESTART && lbdQueue.isvalid() && trail.size() > R * trailQueue.getavg()) {
@@ -1533,12 +2211,18 @@ lbool Solver::search(int nof_conflicts) {
             learnt_clause.clear();
             selectors.clear();
 
-            analyze(confl, learnt_clause, selectors, backtrack_level, nblevels, szWithoutSelectors);
+            analyze(confl, confl_level, learnt_clause, selectors, backtrack_level, nblevels, szWithoutSelectors);
 
             lbdQueue.push(nblevels);
             sumLBD += nblevels;
 
-            cancelUntil(backtrack_level);
+            // Long backjumps undo and redo large parts of the trail, the literals of the levels in
+            // between stay assigned with chronological backtracking
+            if(chronoEnabled() && confl_level - backtrack_level > chrono) {
+                stats[nbChronoBacktracks]++;
+                cancelUntil(confl_level - 1);
+            } else
+                cancelUntil(backtrack_level);
 
             if(certifiedUNSAT) {
                 if(vbyte) {
@@ -1557,7 +2241,7 @@ lbool Solver::search(int nof_conflicts) {
 
 
             if(learnt_clause.size() == 1) {
-                uncheckedEnqueue(learnt_clause[0]);
+                uncheckedEnqueue(learnt_clause[0], 0, CRef_Undef);
                 stats[nbUn]++;
                 parallelExportUnaryClause(learnt_clause[0]);
             } else {
@@ -1573,15 +2257,12 @@ lbool Solver::search(int nof_conflicts) {
                     learnts.push(cr);
                     claBumpActivity(ca[cr]);
                 }
-#ifdef INCREMENTAL
-                ca[cr].setSizeWithoutSelectors(szWithoutSelectors);
-#endif
                 if(nblevels <= 2) { stats[nbDL2]++; } // stats
                 if(ca[cr].size() == 2) stats[nbBin]++; // stats
                 attachClause(cr);
                 lastLearntClause = cr; // Use in multithread (to hard to put inside ParallelSolver)
                 parallelExportClauseDuringSearch(ca[cr]);
-                uncheckedEnqueue(learnt_clause[0], cr);
+                uncheckedEnqueue(learnt_clause[0], backtrack_level, cr);
 
             }
             varDecayActivity();
@@ -1606,6 +2287,8 @@ lbool Solver::search(int nof_conflicts) {
                 }
 
                 cancelUntil(bt);
+                if(rephase && conflicts >= rephaseConflicts)
+                    rephasePolarities();
                 return l_Undef;
             }
 
@@ -1621,6 +2304,7 @@ lbool Solver::search(int nof_conflicts) {
                 if(learnts.size() > 0) {
                     curRestart = (conflicts / nbclausesbeforereduce) + 1;
                     reduceDB();
+                    vivifyPending = vivify;
                     if(!panicModeIsEnabled())
                         nbclausesbeforereduce += incReduceDB;
                 }
@@ -1650,6 +2334,8 @@ lbool Solver::search(int nof_conflicts) {
                 if(next == lit_Undef) {
 		  //printf("c last restart ## conflicts  :  %d %d \n", conflictC, decisionLevel());
                     // Model found:
+                    best_assigned = trail.size();
+                    savePhases(best_phase, best_assigned);
                     return l_True;
                 }
             }
@@ -1708,6 +2394,23 @@ void Solver::printIncrementalStats() {
     printf("c propagations          : %"
     PRIu64
     "\n", propagations);
+    printf("c reused assumption lvls: %"
+    PRIu64
+    "\n", stats[reusedAssumptionLevels]);
+    printf("c vivification rounds   : %"
+    PRIu64
+    "\n", stats[nbVivifyRounds]);
+    printf("c vivified learnts      : %"
+    PRIu64
+    " (%"
+    PRIu64
+    " literals removed)\n", stats[nbVivifiedClauses], stats[nbVivifiedLiterals]);
+    printf("c rephasings            : %"
+    PRIu64
+    "\n", stats[nbRephases]);
+    printf("c chrono backtracks     : %"
+    PRIu64
+    "\n", stats[nbChronoBacktracks]);
 
     printf("\nc SAT Calls             : %d in %g seconds\n", nbSatCalls, totalTime4Sat);
     printf("c UNSAT Calls           : %d in %g seconds\n", nbUnsatCalls, totalTime4Unsat);
@@ -1748,6 +2451,32 @@ lbool Solver::solve_(bool do_simp, bool turn_off_simp) // Parameters are useless
     if(!ok) return l_False;
     double curTime = cpuTime();
 
+    // Short incremental calls may never reach a reduceDB, the learnts they accumulate are vivified
+    // between the calls. Vivification needs the root level, so it gives up the assumption levels
+    // of the last call.
+    if(vivifyPending || (vivify && conflicts >= vivifyConflicts + firstReduceDB)) {
+        cancelUntil(0);
+        vivifyLearnts();
+        if(!ok) return l_False;
+    }
+
+    // Start from the best assignment the caller knows of (e.g. the incumbent of a MaxSAT search)
+    if(bestSeeded) {
+        for(Var v = 0; v < nVars(); v++) {
+            if(!fixed_polarity[v]) polarity[v] = best_phase[v];
+            target_phase[v] = 2;
+        }
+        target_assigned = 0;
+        bestSeeded = false;
+    }
+
+    // Keep the decision levels of the assumptions shared with the last call
+    int shared = 0;
+    while(shared < decisionLevel() && shared < assumptions.size() && assumptions[shared] == trailAssumptions[shared])
+        shared++;
+    cancelUntil(shared);
+    stats[reusedAssumptionLevels] += shared;
+
     solves++;
 
 
@@ -1794,6 +2523,10 @@ lbool Solver::solve_(bool do_simp, bool turn_off_simp) // Parameters are useless
                 luby_restart ? luby(restart_inc, curr_restarts) * luby_restart_factor : 0); // the parameter is useless in glucose, kept to allow modifications
 
         if(!withinBudget()) break;
+        if(status == l_Undef && vivifyPending && decisionLevel() == 0) {
+            vivifyLearnts();
+            if(!ok) status = l_False;
+        }
         curr_restarts++;
     }
 
@@ -1822,7 +2555,13 @@ lbool Solver::solve_(bool do_simp, bool turn_off_simp) // Parameters are useless
         ok = false;
 
 
-    cancelUntil(0);
+    // The assumption levels are kept for the next call, clauses added in
+    // between backtrack lazily (see addClause_)
+    if(ok && assumptions.size() > 0) {
+        cancelUntil(assumptions.size());
+        assumptions.copyTo(trailAssumptions);
+    } else
+        cancelUntil(0);
 
 
     double finalTime = cpuTime();
@@ -1928,6 +2667,7 @@ void Solver::relocAll(ClauseAllocator &to) {
     // for (int i = 0; i < watches.size(); i++)
     watches.cleanAll();
     watchesBin.cleanAll();
+    watchesTern.cleanAll();
     unaryWatches.cleanAll();
     for(int v = 0; v < nVars(); v++)
         for(int s = 0; s < 2; s++) {
@@ -1942,6 +2682,9 @@ void Solver::relocAll(ClauseAllocator &to) {
             vec <Watcher> &ws3 = unaryWatches[p];
             for(int j = 0; j < ws3.size(); j++)
                 ca.reloc(ws3[j].cref, to);
+            vec <TernaryWatcher> &ws4 = watchesTern[p];
+            for(int j = 0; j < ws4.size(); j++)
+                ca.reloc(ws4[j].cref, to);
         }
 
     // All reasons:
@@ -1949,10 +2692,17 @@ void Solver::relocAll(ClauseAllocator &to) {
     for(int i = 0; i < trail.size(); i++) {
         Var v = var(trail[i]);
 
-        if(reason(v) != CRef_Undef && (ca[reason(v)].reloced() || locked(ca[reason(v)])))
+        if(reason(v) != CRef_Undef && reason(v) != CRef_AMO && (ca[reason(v)].reloced() || locked(ca[reason(v)])))
             ca.reloc(vardata[v].reason, to);
     }
 
+    // Scratch clauses of the at-most-one constraints:
+    //
+    if(amoReasonRef != CRef_Undef) {
+        ca.reloc(amoReasonRef, to);
+        ca.reloc(amoConflictRef, to);
+    }
+
     // All learnt:
     //
     for(int i = 0; i < learnts.size(); i++)
@@ -1975,11 +2725,96 @@ void Solver::garbageCollect() {
     // Initialize the next region to a size corresponding to the estimated utilization degree. This
     // is not precise but should avoid some unnecessary reallocations for the new region:
     ClauseAllocator to(ca.size() - ca.wasted());
+    ca.shareTo(to);
     relocAll(to);
     if(verbosity >= 2)
         printf("|  Garbage collection:   %12d bytes => %12d bytes             |\n",
                ca.size() * ClauseAllocator::Unit_Size, to.size() * ClauseAllocator::Unit_Size);
     to.moveTo(ca);
+    compactWatches();
+}
+
+
+// The clauses are relocated in the order of the watch lists, the watch lists that shrank since
+// they grew give their unused memory back
+template<class W>
+static void releaseSlack(vec <W> &ws) {
+    if(ws.capacity() > 2 * ws.size() + 4) {
+        vec <W> tmp;
+        ws.copyTo(tmp);
+        tmp.moveTo(ws);
+    }
+}
+
+void Solver::compactWatches() {
+    for(int v = 0; v < nVars(); v++)
+        for(int s = 0; s < 2; s++) {
+            Lit p = mkLit(v, s);
+            releaseSlack(watches[p]);
+            releaseSlack(watchesBin[p]);
+            releaseSlack(watchesTern[p]);
+        }
+}
+
+
+// Moves the original clauses to a read-only prefix of the clause arena. The copies made by the copy
+// constructor map this prefix instead of duplicating it, only the learnt clauses are private. The
+// literals of a shared clause are never reordered, 'sharedWatchSum' tracks its two watches instead.
+// The simplifier must be turned off, its occurrence lists are not relocated.
+bool Solver::shareClauses() {
+#ifdef MMAP_ARENA
+    assert(decisionLevel() == 0);
+    if(ca.sharedSize() > 0 || clauses.size() == 0)
+        return false;
+
+    // Shared clauses need the extra field for their index
+    ClauseAllocator to(ca.size() - ca.wasted());
+    to.extra_clause_field = true;
+    sharedWatchSum.clear();
+    for(int i = 0; i < clauses.size(); i++) {
+        if(ca[clauses[i]].mark()) continue;
+        CRef cr = clauses[i]; // (relocAll updates 'clauses' afterwards)
+        ca.reloc(cr, to);
+        Clause &c = to[cr];
+        c.setShared(sharedWatchSum.size());
+        sharedWatchSum.push(toInt(c[0]) ^ toInt(c[1]));
+    }
+    to.extra_clause_field = ca.extra_clause_field;
+    to.share();
+    Solver::relocAll(to);
+    if(verbosity >= 2)
+        printf("|  Shared clauses:       %12d bytes, private %12d bytes             |\n",
+               to.sharedSize() * ClauseAllocator::Unit_Size, (to.size() - to.sharedSize()) * ClauseAllocator::Unit_Size);
+    to.moveTo(ca);
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+// The learnt clauses are implied by the clauses of the solver, a new solver with the same clauses
+// can start with them. Clauses over other variables (e.g. those of encodings added later on) and
+// the units of the assumption levels are left out.
+void Solver::exportLearnts(vec<Lit>& out, int nv, unsigned int max_lbd) const {
+    for(Var v = 0; v < nv && v < nVars(); v++)
+        if(value(v) != l_Undef && level(v) == 0) {
+            out.push(mkLit(v, value(v) == l_False));
+            out.push(lit_Undef);
+        }
+
+    const vec<CRef>* lists[] = {&permanentLearnts, &learnts};
+    for(int l = 0; l < 2; l++)
+        for(int i = 0; i < lists[l]->size(); i++) {
+            const Clause& c = ca[(*lists[l])[i]];
+            if(c.mark() || c.lbd() > max_lbd) continue;
+            int j = 0;
+            while(j < c.size() && var(c[j]) < nv) j++;
+            if(j < c.size()) continue;
+            for(j = 0; j < c.size(); j++)
+                out.push(c[j]);
+            out.push(lit_Undef);
+        }
 }
 
 //--------------------------------------------------------------
@@ -87,10 +87,16 @@ enum CoreStats {
   learnts_literals,
   max_literals,
   tot_literals,
-  noDecisionConflict
+  noDecisionConflict,
+  reusedAssumptionLevels,
+  nbVivifyRounds,
+  nbVivifiedClauses,
+  nbVivifiedLiterals,
+  nbRephases,
+  nbChronoBacktracks
 } ;
 
-#define coreStatsSize 24
+#define coreStatsSize 30
 //=================================================================================================
 // Solver -- the main class:
 
@@ -124,6 +130,7 @@ public:
     bool    addClause (Lit p, Lit q, Lit r);                    // Add a ternary clause to the solver. 
     virtual bool    addClause_(      vec<Lit>& ps);                     // Add a clause to the solver without making superflous internal copy. Will
                                                                 // change the passed vector 'ps'.
+    virtual bool addAtMostOne(const vec<Lit>& ps);              // Add a native at-most-one constraint over 'ps' to the solver.
     // Solving:
     //
     bool    simplify     ();                        // Removes already satisfied clauses.
@@ -153,6 +160,9 @@ public:
     // 
     void    setPolarity    (Var v, bool b); // Declare which polarity the decision heuristic should use for a variable. Requires mode 'polarity_user'.
     void    setDecisionVar (Var v, bool b); // Declare if a variable should be eligible for selection in the decision heuristic.
+    void    setActivity    (Var v, double act); // Initial activity of a variable, conflicts bump it as usual.
+    void    setInitialPolarity(Var v, bool b);  // Initial polarity of a variable, phase saving may change it.
+    void    setBestPhase   (Var v, bool b); // Polarity of a variable in the best known assignment, restored by the next call to solve.
 
     // Read state:
     //
@@ -164,6 +174,7 @@ public:
     int     nClauses   ()      const;       // The current number of original clauses.
     int     nLearnts   ()      const;       // The current number of learnt clauses.
     int     nVars      ()      const;       // The current number of variables.
+    int     nAtMostOnes()      const;       // The current number of native at-most-one constraints.
     int     nFreeVars  ()      ;
 
     inline char valuePhase(Var v) {return polarity[v];}
@@ -186,6 +197,12 @@ public:
     virtual void garbageCollect();
     void    checkGarbage(double gf);
     void    checkGarbage();
+    bool    shareClauses();       // Makes the original clauses read-only and shared with the clones (needs ARENA=mmap).
+
+    // Checkpoints:
+    //
+    void    exportLearnts(vec<Lit>& out, int nv, unsigned int max_lbd) const; // Appends the root level units and the learnt clauses over the variables below 'nv' with an LBD up to 'max_lbd', each one closed by lit_Undef.
+    double  getActivity  (Var v) const; // Current activity of a variable (see 'setActivity()').
 
     // Extra results: (read-only member variable)
     //
@@ -215,6 +232,10 @@ public:
     // Constant for reducing clause
     int          lbSizeMinimizingClause;
     unsigned int lbLBDMinimizingClause;
+    // Constants for vivifying learnt clauses
+    bool         vivify;
+    unsigned int vivifyLBD;
+    double       vivifyEffort;
 
     // Constant for heuristic
     double    var_decay;
@@ -225,6 +246,13 @@ public:
     int       ccmin_mode;         // Controls conflict clause minimization (0=none, 1=basic, 2=deep).
     int       phase_saving;       // Controls the level of phase saving (0=none, 1=limited, 2=full).
     bool      rnd_pol;            // Use random polarities for branching heuristics.
+    int       target_phases;      // Branch on the polarities of the longest conflict-free trail since the last rephasing (0=never, 1=improving a model, 2=always).
+    bool      rephase;            // Periodically reset the polarities (best, original, inverted, random walk).
+    int       rephase_int;        // Conflicts before the first rephasing, the interval grows arithmetically.
+    double    walk_effort;        // Flips of a random walk, relative to the number of original clauses.
+    int       chrono;             // Backtrack chronologically when the backjump skips more levels (-1=never).
+    bool      ternary;            // Keep both other literals of a ternary clause in its watchers.
+    bool      prefetch;           // Prefetch the clauses of the next watchers during propagation.
     bool      rnd_init_act;       // Initialize variable activities with a small random value.
     bool      randomizeFirstDescent; // the first decisions (until first cnflict) are made randomly
                                      // Useful for syrup!
@@ -291,6 +319,7 @@ protected:
         CRef cref;
         Lit  blocker;
         Watcher(CRef cr, Lit p) : cref(cr), blocker(p) {}
+        Watcher() : cref(CRef_Undef), blocker(lit_Undef) {}
         bool operator==(const Watcher& w) const { return cref == w.cref; }
         bool operator!=(const Watcher& w) const { return cref != w.cref; }
 /*        Watcher &operator=(Watcher w) {
@@ -308,6 +337,24 @@ protected:
         bool operator()(const Watcher& w) const { return ca[w.cref].mark() == 1; }
     };
 
+    // The watchers of a ternary clause keep both other literals, the clause is only read when its
+    // watch moves. The literal it implies may be anywhere in it.
+    struct TernaryWatcher {
+        CRef cref;
+        Lit  other1, other2;
+        TernaryWatcher(CRef cr, Lit p, Lit q) : cref(cr), other1(p), other2(q) {}
+        TernaryWatcher() : cref(CRef_Undef), other1(lit_Undef), other2(lit_Undef) {}
+        bool operator==(const TernaryWatcher& w) const { return cref == w.cref; }
+        bool operator!=(const TernaryWatcher& w) const { return cref != w.cref; }
+    };
+
+    struct TernaryWatcherDeleted
+    {
+        const ClauseAllocator& ca;
+        TernaryWatcherDeleted(const ClauseAllocator& _ca) : ca(_ca) {}
+        bool operator()(const TernaryWatcher& w) const { return ca[w.cref].mark() == 1; }
+    };
+
     struct VarOrderLt {
         const vec<double>&  activity;
         bool operator () (Var x, Var y) const { return activity[x] > activity[y]; }
@@ -326,16 +373,37 @@ protected:
                         watches;          // 'watches[lit]' is a list of constraints watching 'lit' (will go there if literal becomes true).
     OccLists<Lit, vec<Watcher>, WatcherDeleted>
                         watchesBin;          // 'watches[lit]' is a list of constraints watching 'lit' (will go there if literal becomes true).
+    OccLists<Lit, vec<TernaryWatcher>, TernaryWatcherDeleted>
+                        watchesTern;      // 'watchesTern[lit]' is the list of ternary clauses watching 'lit' (see 'isTernary()').
     OccLists<Lit, vec<Watcher>, WatcherDeleted>
                         unaryWatches;       //  Unary watch scheme (clauses are seen when they become empty
+    vec<uint32_t>       sharedWatchSum;   // Xor of the two literals watching each shared clause, indexed by 'sharedIndex()'.
     vec<CRef>           clauses;          // List of problem clauses.
     vec<CRef>           learnts;          // List of learnt clauses.
     vec<CRef>           permanentLearnts; // The list of learnts clauses kept permanently
     vec<CRef>           unaryWatchedClauses;  // List of imported clauses (after the purgatory) // TODO put inside ParallelSolver
 
+    // Native at-most-one constraints: the literals of constraint i are amoLits[amoStart[i]..amoStart[i+1]).
+    // When a literal becomes true, the other literals of its constraints are falsified with the reason
+    // CRef_AMO and amoImplier[var] holds the true literal. The binary clauses equivalent to a reason or
+    // to a conflict are materialized on demand in two scratch clauses.
+    vec<Lit>            amoLits;
+    vec<int>            amoStart;
+    vec<vec<int> >      amoWatches;       // 'amoWatches[toInt(lit)]' lists the at-most-one constraints containing 'lit'.
+    vec<Lit>            amoImplier;
+    CRef                amoReasonRef;
+    CRef                amoConflictRef;
+
     vec<lbool>          assigns;          // The current assignments.
     vec<char>           polarity;         // The preferred polarity of each variable.
     vec<char>           fixed_polarity;   // Open-WBO: fixed polarity for solution phase saving
+    vec<char>           orig_phase;       // The initial polarity of each variable.
+    vec<char>           target_phase;     // Polarities of the longest conflict-free trail since the last rephasing (2 if unset).
+    vec<char>           best_phase;       // Polarities of the longest conflict-free trail (or the last model) seen.
+    int                 target_assigned;  // Size of the trail saved in 'target_phase'.
+    int                 best_assigned;    // Size of the trail saved in 'best_phase'.
+    bool                bestSeeded;       // 'setBestPhase()' was called since the last call to solve.
+    uint64_t            rephaseConflicts; // Value of 'conflicts' at which the next rephasing happens.
     vec<char>           forceUNSAT;
     void                bumpForceUNSAT(Lit q); // Handles the forces
 
@@ -348,9 +416,13 @@ protected:
     int                 simpDB_assigns;   // Number of top-level assignments since last execution of 'simplify()'.
     int64_t             simpDB_props;     // Remaining number of propagations that must be made before next execution of 'simplify()'.
     vec<Lit>            assumptions;      // Current set of assumptions provided to solve by the user.
+    vec<Lit>            trailAssumptions; // Assumptions of the decision levels kept on the trail by the last call to solve.
     Heap<VarOrderLt>    order_heap;       // A priority queue of variables ordered with respect to the variable activity.
     double              progress_estimate;// Set by 'search()'.
     bool                remove_satisfied; // Indicates whether possibly inefficient linear scan for satisfied clauses should be performed in 'simplify'.
+    bool                vivifyPending;    // A reduceDB happened since the last vivification of the learnts.
+    uint64_t            vivifyProps;      // Value of 'propagations' after the last vivification.
+    uint64_t            vivifyConflicts;  // Value of 'conflicts' after the last vivification.
     vec<unsigned int>   permDiff;           // permDiff[var] contains the current conflict number... Used to count the number of  LBD
     
 
@@ -375,6 +447,7 @@ protected:
     vec<Lit>            analyze_stack;
     vec<Lit>            analyze_toclear;
     vec<Lit>            add_tmp;
+    vec<Lit>            cancel_kept;
     unsigned int  MYFLAG;
 
     // Initial reduceDB strategy
@@ -402,18 +475,30 @@ protected:
     Lit      pickBranchLit    ();                                                      // Return the next decision variable.
     void     newDecisionLevel ();                                                      // Begins a new decision level.
     void     uncheckedEnqueue (Lit p, CRef from = CRef_Undef);                         // Enqueue a literal. Assumes value of literal is undefined.
+    void     uncheckedEnqueue (Lit p, int level, CRef from);                           // Enqueue a literal implied at a lower level (chronological backtracking).
     bool     enqueue          (Lit p, CRef from = CRef_Undef);                         // Test if fact 'p' contradicts current state, enqueue otherwise.
     CRef     propagate        ();                                                      // Perform unit propagation. Returns possibly conflicting clause.
     CRef     propagateUnaryWatches(Lit p);                                                  // Perform propagation on unary watches of p, can find only conflicts
+    CRef     propagateAtMostOne(Lit p);                                               // Perform propagation on the at-most-one constraints containing p
     void     cancelUntil      (int level);                                             // Backtrack until a certain level.
-    void     analyze          (CRef confl, vec<Lit>& out_learnt, vec<Lit> & selectors, int& out_btlevel,unsigned int &nblevels,unsigned int &szWithoutSelectors);    // (bt = backtrack)
+    void     analyze          (CRef confl, int confl_level, vec<Lit>& out_learnt, vec<Lit> & selectors, int& out_btlevel,unsigned int &nblevels,unsigned int &szWithoutSelectors);    // (bt = backtrack)
+    int      conflictLevel    (CRef confl, bool& single);                              // Highest level of a conflict, moves its literal to c[0].
+    void     moveWatch        (CRef cr, int w, int i);                                 // Swaps c[i] with the watched literal c[w] and updates the watches.
+    bool     chronoEnabled    () const;                                                // Chronological backtracking is enabled and supported by the clauses.
+    bool     isTernary        (const Clause& c) const;                                 // The clause is watched in 'watchesTern'.
+    void     compactWatches   ();                                                      // Releases the unused capacity of the watch lists.
     void     analyzeFinal     (Lit p, vec<Lit>& out_conflict);                         // COULD THIS BE IMPLEMENTED BY THE ORDINARIY "analyze" BY SOME REASONABLE GENERALIZATION?
     bool     litRedundant     (Lit p, uint32_t abstract_levels);                       // (helper method for 'analyze()')
     lbool    search           (int nof_conflicts);                                     // Search for a given number of conflicts.
     virtual lbool    solve_           (bool do_simp = true, bool turn_off_simp = false);                                                      // Main solve method (assumptions given in 'assumptions').
     virtual void     reduceDB         ();                                              // Reduce the set of learnt clauses.
     void     removeSatisfied  (vec<CRef>& cs);                                         // Shrink 'cs' to contain only non-satisfied clauses.
+    void     vivifyLearnts    ();                                                      // Shorten the best learnts by propagating their negation (at level 0).
+    bool     vivifyClause     (CRef cr, vec<Lit>& out_lits);                           // Computes the literals of 'cr' that are needed, TRUE if some are not.
     void     rebuildOrderHeap ();
+    void     savePhases       (vec<char>& phases, int end);                            // Saves the polarities of 'trail[0..end)' in 'phases'.
+    void     rephasePolarities();                                                      // Resets the polarities, see 'rephase'.
+    void     walkPhases       ();                                                      // Random walk over the original clauses from the polarities.
 
     void     adaptSolver();                                                            // Adapt solver strategies
 
@@ -445,7 +530,9 @@ protected:
     int      decisionLevel    ()      const; // Gives the current decisionlevel.
     uint32_t abstractLevel    (Var x) const; // Used to represent an abstraction of sets of decision levels.
     CRef     reason           (Var x) const;
+    CRef     reasonClause     (Var x);       // As 'reason()', but materializes the reason of an at-most-one implication.
     int      level            (Var x) const;
+    lbool    rootValue        (Lit p) const; // The value of a literal at decision level 0.
     double   progressEstimate ()      const; // DELETE THIS ?? IT'S NOT VERY USEFUL ...
     bool     withinBudget     ()      const;
     inline bool isSelector(Var v) {return (incremental && v>nbVarsInitialFormula);}
@@ -470,7 +557,14 @@ protected:
 // Implementation of inline methods:
 
 inline CRef Solver::reason(Var x) const { return vardata[x].reason; }
+inline CRef Solver::reasonClause(Var x) {
+    if (vardata[x].reason != CRef_AMO) return vardata[x].reason;
+    Clause& c = ca[amoReasonRef];
+    c[0] = mkLit(x, value(x) == l_False);
+    c[1] = ~amoImplier[x];
+    return amoReasonRef; }
 inline int  Solver::level (Var x) const { return vardata[x].level; }
+inline lbool Solver::rootValue (Lit p) const { return level(var(p)) == 0 ? value(p) : l_Undef; }
 
 inline void Solver::insertVarOrder(Var x) {
     if (!order_heap.inHeap(x) && decision[x]) order_heap.insert(x); }
@@ -509,12 +603,16 @@ inline bool     Solver::addClause       (Lit p)                 { add_tmp.clear(
 inline bool     Solver::addClause       (Lit p, Lit q)          { add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); return addClause_(add_tmp); }
 inline bool     Solver::addClause       (Lit p, Lit q, Lit r)   { add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); add_tmp.push(r); return addClause_(add_tmp); }
  inline bool     Solver::locked          (const Clause& c) const { 
+   if(isTernary(c)) // (not reordered)
+     for(int i = 0; i < 3; i++)
+       if(value(c[i]) == l_True && reason(var(c[i])) != CRef_Undef && reason(var(c[i])) != CRef_AMO && ca.lea(reason(var(c[i]))) == &c)
+         return true;
    if(c.size()>2) 
-     return value(c[0]) == l_True && reason(var(c[0])) != CRef_Undef && ca.lea(reason(var(c[0]))) == &c; 
+     return value(c[0]) == l_True && reason(var(c[0])) != CRef_Undef && reason(var(c[0])) != CRef_AMO && ca.lea(reason(var(c[0]))) == &c; 
    return 
-     (value(c[0]) == l_True && reason(var(c[0])) != CRef_Undef && ca.lea(reason(var(c[0]))) == &c)
+     (value(c[0]) == l_True && reason(var(c[0])) != CRef_Undef && reason(var(c[0])) != CRef_AMO && ca.lea(reason(var(c[0]))) == &c)
      || 
-     (value(c[1]) == l_True && reason(var(c[1])) != CRef_Undef && ca.lea(reason(var(c[1]))) == &c);
+     (value(c[1]) == l_True && reason(var(c[1])) != CRef_Undef && reason(var(c[1])) != CRef_AMO && ca.lea(reason(var(c[1]))) == &c);
  }
 inline void     Solver::newDecisionLevel()                      { trail_lim.push(trail.size()); }
 
@@ -528,10 +626,15 @@ inline int      Solver::nAssigns      ()      const   { return trail.size(); }
 inline int      Solver::nClauses      ()      const   { return clauses.size(); }
 inline int      Solver::nLearnts      ()      const   { return learnts.size(); }
 inline int      Solver::nVars         ()      const   { return vardata.size(); }
+inline int      Solver::nAtMostOnes   ()      const   { return amoStart.size() > 0 ? amoStart.size() - 1 : 0; }
 inline int      Solver::nFreeVars     ()         { 
     int a = stats[dec_vars];
     return (int)(a) - (trail_lim.size() == 0 ? trail.size() : trail_lim[0]); }
 inline void     Solver::setPolarity   (Var v, bool b) { polarity[v] = b; fixed_polarity[v] = true; }
+inline void     Solver::setActivity   (Var v, double act) { activity[v] = act; if (order_heap.inHeap(v)) order_heap.update(v); }
+inline double   Solver::getActivity   (Var v) const { return activity[v]; }
+inline void     Solver::setInitialPolarity(Var v, bool b) { if (!fixed_polarity[v]) polarity[v] = orig_phase[v] = b; }
+inline void     Solver::setBestPhase  (Var v, bool b) { best_phase[v] = b; best_assigned = nVars(); bestSeeded = true; }
 inline void     Solver::setDecisionVar(Var v, bool b) 
 { 
     if      ( b && !decision[v]) stats[dec_vars]++;
@@ -549,6 +652,10 @@ inline bool     Solver::withinBudget() const {
     return !asynch_interrupt &&
            (conflict_budget    < 0 || conflicts < (uint64_t)conflict_budget) &&
            (propagation_budget < 0 || propagations < (uint64_t)propagation_budget); }
+// The out of order trail needs to reorder the clauses (shared clauses cannot be) and the clauses to
+// propagate (unary watched clauses do not)
+inline bool     Solver::chronoEnabled() const { return chrono >= 0 && sharedWatchSum.size() == 0 && !useUnaryWatched; }
+inline bool     Solver::isTernary(const Clause& c) const { return ternary && c.size() == 3 && !c.shared(); }
 
 // FIXME: after the introduction of asynchronous interrruptions the solve-versions that return a
 // pure bool do not give a safe interface. Either interrupts must be possible to turn off here, or
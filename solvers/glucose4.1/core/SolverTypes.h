@@ -152,10 +152,7 @@ inline lbool toLbool(int   v) { return lbool((uint8_t)v);  }
 class Clause;
 typedef RegionAllocator<uint32_t>::Ref CRef;
 
-#define BITS_LBD 20 
-#ifdef INCREMENTAL
-  #define BITS_SIZEWITHOUTSEL 19
-#endif
+#define BITS_LBD 19 
 #define BITS_REALSIZE 32
 class Clause {
     struct {
@@ -167,13 +164,11 @@ class Clause {
       unsigned reloced    : 1;
       unsigned exported   : 2; // Values to keep track of the clause status for exportations
       unsigned oneWatched : 1;
+      unsigned shared     : 1; // In the read-only prefix of the allocator, see Solver::shareClauses
+      unsigned vivified   : 1;
       unsigned lbd : BITS_LBD;
 
       unsigned size       : BITS_REALSIZE;
-
-#ifdef INCREMENTAL
-      unsigned szWithoutSelectors : BITS_SIZEWITHOUTSEL;
-#endif
     }  header;
 
     union { Lit lit; float act; uint32_t abs; CRef rel; } data[0];
@@ -193,6 +188,8 @@ class Clause {
 	header.canbedel = 1;
 	header.exported = 0; 
 	header.oneWatched = 0;
+	header.shared = 0;
+	header.vivified = 0;
 	header.seen = 0;
         for (int i = 0; i < ps.size(); i++) 
             data[i].lit = ps[i];
@@ -264,10 +261,13 @@ public:
     unsigned int getExported() {return header.exported;}
     void setOneWatched(bool b) {header.oneWatched = b;}
     bool getOneWatched() {return header.oneWatched;}
-#ifdef INCREMNENTAL
-    void setSizeWithoutSelectors   (unsigned int n)              {header.szWithoutSelectors = n; }
-    unsigned int        sizeWithoutSelectors   () const        { return header.szWithoutSelectors; }
-#endif
+    void setVivified(bool b) {header.vivified = b;}
+    bool getVivified() {return header.vivified;}
+
+    // Shared clauses are never written, their extra field holds an index instead of the abstraction
+    bool         shared      ()      const   { return header.shared; }
+    uint32_t     sharedIndex () const        { assert(header.shared); return data[header.size].abs; }
+    void         setShared   (uint32_t index){ assert(header.extra_size > 0); header.shared = 1; data[header.size].abs = index; }
 
 };
 
@@ -277,6 +277,7 @@ public:
 
 
     const CRef CRef_Undef = RegionAllocator<uint32_t>::Ref_Undef;
+    const CRef CRef_AMO   = RegionAllocator<uint32_t>::Ref_Undef - 1; // reason of a literal falsified by an at-most-one constraint
     class ClauseAllocator : public RegionAllocator<uint32_t>
     {
         static int clauseWord32Size(int size, int extra_size){
@@ -322,6 +323,7 @@ public:
         {
             Clause& c = operator[](cr);
 
+            if (c.shared()) return; // 'to' maps the same prefix
             if (c.reloced()) { cr = c.relocation(); return; }
 
             cr = to.alloc(c, c.learnt(), c.wasImported());
@@ -335,10 +337,8 @@ public:
                 to[cr].setLBD(c.lbd());
                 to[cr].setExported(c.getExported());
                 to[cr].setOneWatched(c.getOneWatched());
-#ifdef INCREMENTAL
-                to[cr].setSizeWithoutSelectors(c.sizeWithoutSelectors());
-#endif
                 to[cr].setCanBeDel(c.canBeDel());
+                to[cr].setVivified(c.getVivified());
                 if (c.wasImported()) {
                     to[cr].setImportedFrom(c.importedFrom());
                 }
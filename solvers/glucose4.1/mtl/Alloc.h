@@ -24,10 +24,27 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "mtl/XAlloc.h"
 #include "mtl/Vec.h"
 
+#ifdef MMAP_ARENA
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
 namespace Glucose {
 
 //=================================================================================================
 // Simple Region-based memory allocator:
+//
+// With MMAP_ARENA the region reserves address space up front and only commits pages when it grows.
+// Growing within the reservation never moves the region, so it costs no copy, and the region is
+// backed by transparent huge pages where the kernel supports them. The reservation is 2^32
+// elements, or an eighth of the address space limit (RLIMIT_AS) when there is one. A region that
+// outgrows its reservation, or cannot reserve it, is moved to the heap and grows with 'xrealloc'.
+//
+// 'share()' also turns the current content of the region into a read-only prefix backed by a
+// memory file. Copies of the region map the same file instead of duplicating the prefix, so it
+// is stored once however many copies there are. Only the elements after the prefix are private.
+// A region on the heap keeps the prefix but copies it.
 
 template<class T>
 class RegionAllocator
@@ -38,6 +55,19 @@ class RegionAllocator
     uint32_t  wasted_;
 
     void capacity(uint32_t min_cap);
+    static void refLimit();
+#ifdef MMAP_ARENA
+    enum { Huge_Page = 2*1024*1024 };
+
+    void*     reserved;      // Start of the mapping, 'memory' is aligned to a huge page inside it (NULL on the heap).
+    size_t    reserved_size;
+    int       shared_fd;     // Memory file holding the shared prefix, -1 if there is none.
+    uint32_t  shared_sz;
+
+    void reserve();
+    void toHeap(uint32_t new_cap);
+    void release();
+#endif
 
  public:
     // TODO: make this a class for better type-checking?
@@ -45,17 +75,31 @@ class RegionAllocator
     enum { Ref_Undef = UINT32_MAX };
     enum { Unit_Size = sizeof(uint32_t) };
 
+#ifdef MMAP_ARENA
+    explicit RegionAllocator(uint32_t start_cap = 1024*1024) : memory(NULL), sz(0), cap(0), wasted_(0), reserved(NULL), reserved_size(0), shared_fd(-1), shared_sz(0){ capacity(start_cap); }
+    ~RegionAllocator() { release(); }
+#else
     explicit RegionAllocator(uint32_t start_cap = 1024*1024) : memory(NULL), sz(0), cap(0), wasted_(0){ capacity(start_cap); }
     ~RegionAllocator()
     {
         if (memory != NULL)
             ::free(memory);
     }
+#endif
 
 
     uint32_t size      () const      { return sz; }
     uint32_t getCap    () const      { return cap;}
     uint32_t wasted    () const      { return wasted_; }
+#ifdef MMAP_ARENA
+    uint32_t sharedSize() const      { return shared_sz; }
+
+    void     share     ();
+    void     shareTo   (RegionAllocator& to) const;
+#else
+    uint32_t sharedSize() const      { return 0; }
+    void     shareTo   (RegionAllocator& to) const {}
+#endif
 
     Ref      alloc     (int size); 
     void     free      (int size)    { wasted_ += size; }
@@ -70,7 +114,19 @@ class RegionAllocator
         return  (Ref)(t - &memory[0]); }
 
     void     moveTo(RegionAllocator& to) {
+#ifdef MMAP_ARENA
+        to.release();
+        to.reserved = reserved;
+        to.reserved_size = reserved_size;
+        to.shared_fd = shared_fd;
+        to.shared_sz = shared_sz;
+        reserved = NULL;
+        reserved_size = 0;
+        shared_fd = -1;
+        shared_sz = 0;
+#else
         if (to.memory != NULL) ::free(to.memory);
+#endif
         to.memory = memory;
         to.sz = sz;
         to.cap = cap;
@@ -80,6 +136,15 @@ class RegionAllocator
         sz = cap = wasted_ = 0;
     }
 
+#ifdef MMAP_ARENA
+    void copyTo(RegionAllocator& to) const {
+        to.capacity(cap);
+        shareTo(to);
+        memcpy(to.memory+shared_sz,memory+shared_sz,sizeof(T)*(sz-shared_sz));
+        to.sz = sz;
+        to.wasted_ = wasted_;
+    }
+#else
     void copyTo(RegionAllocator& to) const {
      //   if (to.memory != NULL) ::free(to.memory);
         to.memory = (T*)xrealloc(to.memory, sizeof(T)*cap);
@@ -88,11 +153,20 @@ class RegionAllocator
         to.cap = cap;
         to.wasted_ = wasted_;
     }
+#endif
 
 
 
 };
 
+// The region is full when its references would not fit in 32 bits, however much memory is left.
+template<class T>
+void RegionAllocator<T>::refLimit()
+{
+    printf("c Error: the region allocator reached the 2^32 elements of its 32-bit references.\n");
+    throw OutOfMemoryException();
+}
+
 template<class T>
 void RegionAllocator<T>::capacity(uint32_t min_cap)
 {
@@ -107,14 +181,134 @@ void RegionAllocator<T>::capacity(uint32_t min_cap)
         cap += delta;
 
         if (cap <= prev_cap)
-            throw OutOfMemoryException();
+            refLimit();
     }
     //printf(" .. (%p) cap = %u\n", this, cap);
 
     assert(cap > 0);
+#ifdef MMAP_ARENA
+    if (memory == NULL)
+        reserve();
+    if (reserved == NULL){
+        memory = (T*)xrealloc(memory, sizeof(T)*cap);
+        return; }
+
+    // Commit whole huge pages, a region that outgrows its reservation moves to the heap.
+    size_t prev_bytes = ((size_t)sizeof(T)*prev_cap + Huge_Page - 1) & ~((size_t)Huge_Page - 1);
+    size_t bytes      = ((size_t)sizeof(T)*cap + Huge_Page - 1) & ~((size_t)Huge_Page - 1);
+    if (bytes > reserved_size - Huge_Page || (bytes > prev_bytes && mprotect((char*)memory + prev_bytes, bytes - prev_bytes, PROT_READ | PROT_WRITE) != 0))
+        toHeap(cap);
+#else
     memory = (T*)xrealloc(memory, sizeof(T)*cap);
+#endif
 }
 
+#ifdef MMAP_ARENA
+template<class T>
+void RegionAllocator<T>::reserve()
+{
+    // Inaccessible pages do not count as committed memory until 'capacity' enables them, but they
+    // count against RLIMIT_AS, which also has to hold the copy made by garbage collection and the
+    // regions of other solvers.
+    size_t size = (size_t)sizeof(T) << 32;
+    rlimit rl;
+    if (getrlimit(RLIMIT_AS, &rl) == 0 && rl.rlim_cur != RLIM_INFINITY && rl.rlim_cur / 8 < size)
+        size = (rl.rlim_cur / 8) & ~((size_t)Huge_Page - 1);
+    if (size == 0)
+        return;
+
+    reserved_size = size + Huge_Page;
+    reserved = mmap(NULL, reserved_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (reserved == MAP_FAILED){
+        reserved = NULL;
+        reserved_size = 0;
+        return;
+    }
+
+    uintptr_t aligned = ((uintptr_t)reserved + Huge_Page - 1) & ~((uintptr_t)Huge_Page - 1);
+    memory = (T*)aligned;
+#ifdef MADV_HUGEPAGE
+    madvise(memory, size, MADV_HUGEPAGE);
+#endif
+}
+
+// Moves the region out of its reservation, the shared prefix becomes a private copy.
+template<class T>
+void RegionAllocator<T>::toHeap(uint32_t new_cap)
+{
+    T* heap = (T*)xrealloc(NULL, sizeof(T)*new_cap);
+    memcpy(heap, memory, sizeof(T)*sz);
+    munmap(reserved, reserved_size);
+    if (shared_fd != -1)
+        close(shared_fd);
+    reserved = NULL;
+    reserved_size = 0;
+    shared_fd = -1;
+    memory = heap;
+}
+
+template<class T>
+void RegionAllocator<T>::release()
+{
+    if (reserved != NULL)
+        munmap(reserved, reserved_size);
+    else if (memory != NULL)
+        ::free(memory);
+    if (shared_fd != -1)
+        close(shared_fd);
+    reserved = NULL;
+    reserved_size = 0;
+    shared_fd = -1;
+    shared_sz = 0;
+    memory = NULL;
+    sz = cap = wasted_ = 0;
+}
+
+template<class T>
+void RegionAllocator<T>::share()
+{
+    assert(shared_fd == -1);
+
+    // The prefix ends on a huge page so that the private part keeps its own pages.
+    size_t bytes = ((size_t)sizeof(T)*sz + Huge_Page - 1) & ~((size_t)Huge_Page - 1);
+    capacity(bytes / sizeof(T));
+    // Without a memory file the copies get their own copy of the prefix.
+    int fd = reserved != NULL ? memfd_create("region", 0) : -1;
+    if (fd == -1){
+        shared_sz = sz;
+        return; }
+    void* file = ftruncate(fd, bytes) == 0 ? mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    if (file == MAP_FAILED){
+        close(fd);
+        shared_sz = sz;
+        return; }
+    memcpy(file, memory, sizeof(T)*sz);
+    munmap(file, bytes);
+
+    if (mmap(memory, bytes, PROT_READ, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED){
+        close(fd);
+        throw OutOfMemoryException(); }
+    shared_fd = fd;
+    shared_sz = sz = bytes / sizeof(T);
+}
+
+template<class T>
+void RegionAllocator<T>::shareTo(RegionAllocator& to) const
+{
+    if (shared_sz == 0) return;
+    assert(to.shared_fd == -1 && to.sz == 0);
+
+    to.capacity(shared_sz);
+    if (shared_fd != -1 && to.reserved != NULL){
+        if (mmap(to.memory, (size_t)sizeof(T)*shared_sz, PROT_READ, MAP_SHARED | MAP_FIXED, shared_fd, 0) == MAP_FAILED)
+            throw OutOfMemoryException();
+        to.shared_fd = dup(shared_fd);
+    }else
+        memcpy(to.memory, memory, sizeof(T)*shared_sz);
+    to.shared_sz = to.sz = shared_sz;
+}
+#endif
+
 
 template<class T>
 typename RegionAllocator<T>::Ref
@@ -129,7 +323,7 @@ RegionAllocator<T>::alloc(int size)
     
     // Handle overflow:
     if (sz < prev_sz)
-        throw OutOfMemoryException();
+        refLimit();
 
     return prev_sz;
 }
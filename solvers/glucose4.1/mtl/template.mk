@@ -26,6 +26,10 @@ COPTIMIZE ?= -O3
 CFLAGS    += -I$(MROOT) -D __STDC_LIMIT_MACROS -D __STDC_FORMAT_MACROS
 LFLAGS    += -lz
 
+ifeq ($(ARENA),mmap)
+CFLAGS    += -DMMAP_ARENA
+endif
+
 .PHONY : s p d r rs clean 
 
 s:	$(EXEC)
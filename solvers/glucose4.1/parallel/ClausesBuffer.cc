@@ -78,156 +78,129 @@ extern BoolOption opt_whenFullRemoveOlder;
 extern IntOption  opt_fifoSizeByCore;
 
 // index : size clause
-// index + 1 : nbSeen
-// index + 2 : threadId
-// index + 3 : .. index + 3 + size : Lit of clause
-ClausesBuffer::ClausesBuffer(int _nbThreads, unsigned int _maxsize) : first(0), last(_maxsize-1),  
-    maxsize(_maxsize), queuesize(0), 
-    removedClauses(0),
-    forcedRemovedClauses(0), nbThreads(_nbThreads), 
-    whenFullRemoveOlder(opt_whenFullRemoveOlder), fifoSizeByCore(opt_fifoSizeByCore) {
-	lastOfThread.growTo(_nbThreads);
-	for(int i=0;i<nbThreads;i++) lastOfThread[i] = _maxsize-1;
-	elems.growTo(maxsize);
+// index + 1 .. index + size : Lit of clause
+ClausesBuffer::ClausesBuffer(int _nbThreads, unsigned int _maxsize) : rings(NULL), cursors(NULL), cursorStride(0),
+    ringSize(0), mask(0), nbThreads(0),
+    whenFullRemoveOlder(opt_whenFullRemoveOlder), fifoSizeByCore(_maxsize / (_nbThreads > 0 ? _nbThreads : 1)) {
+	setNbThreads(_nbThreads);
 } 
 
-ClausesBuffer::ClausesBuffer() : first(0), last(0), maxsize(0), queuesize(0), removedClauses(0), forcedRemovedClauses(0), nbThreads(0),
+ClausesBuffer::ClausesBuffer() : rings(NULL), cursors(NULL), cursorStride(0), ringSize(0), mask(0), nbThreads(0),
                                  whenFullRemoveOlder(opt_whenFullRemoveOlder), fifoSizeByCore(opt_fifoSizeByCore) {}
 
-void ClausesBuffer::setNbThreads(int _nbThreads) {
-    unsigned int _maxsize = fifoSizeByCore*_nbThreads;
-    last = _maxsize -1;
-    maxsize = _maxsize;
-    nbThreads = _nbThreads;
-    lastOfThread.growTo(_nbThreads);
-    for(int i=0;i<nbThreads;i++) lastOfThread[i] = _maxsize-1;
-    elems.growTo(maxsize);
-}
-
-uint32_t ClausesBuffer::getCap() {
-    return elems.capacity();
-}
-inline unsigned int ClausesBuffer::nextIndex(unsigned int i) {
-    i++;
-    if (i == maxsize)
-	return 0;
-    return i;
-}
-
-inline unsigned int ClausesBuffer::addIndex(unsigned int i, unsigned int a) {
-    i += a;
-    if (i >= maxsize)
-	return i - maxsize;
-    return i;
-}
-
-void ClausesBuffer::removeLastClause() {
-    assert(queuesize > 0);
-    do {
-	unsigned int size = (unsigned int) elems[nextIndex(last)];
-	unsigned int nextlast = addIndex(last, size+headerSize);
-
-	for(int i=0;i<nbThreads;i++) {
-	    if (lastOfThread[i] == last)
-		lastOfThread[i] = nextlast;
-	}
-
-	// printf("Removing clause starting at %d of size %d.\n",nextIndex(last), size);
-	for(unsigned int i=0;i<size+headerSize;i++) {
-	    last = nextIndex(last);
-	    assert(queuesize > 0);
-	    queuesize --;
-	}	
-	removedClauses ++;
-	assert(last >= 0);
-	assert(last < maxsize);
-	assert(last == nextlast);
-    } while (queuesize > 0 && (elems[addIndex(last,2)] == 0)); 	
-
+ClausesBuffer::~ClausesBuffer() {
+    release();
 }
 
-
-// Pushes a single uint to the fifo
-inline void ClausesBuffer::noCheckPush(uint32_t x) {
-    elems[first] = x;
-    first = nextIndex(first);
+void ClausesBuffer::release() {
+    if (rings != NULL) {
+	for(int i=0;i<nbThreads;i++) delete [] rings[i].elems;
+	delete [] rings;
+    }
+    delete [] cursors;
+    rings = NULL;
+    cursors = NULL;
 }
 
-// Pops a single uint from the fifo
-inline uint32_t ClausesBuffer::noCheckPop(uint32_t & index) {
-    index = nextIndex(index);
-    uint32_t ret = elems[index];
-    return ret;
+void ClausesBuffer::setNbThreads(int _nbThreads) {
+    release();
+    nbThreads = _nbThreads;
+    ringSize = 2;
+    while (ringSize < fifoSizeByCore) ringSize <<= 1;
+    mask = ringSize - 1;
+
+    rings = new ClauseRing[nbThreads];
+    for(int i=0;i<nbThreads;i++) {
+	rings[i].reserved = 0;
+	rings[i].head = 0;
+	rings[i].elems = new std::atomic<uint32_t>[ringSize];
+	for(uint64_t j=0;j<ringSize;j++) rings[i].elems[j] = 0;
+    }
+    // 8 more positions than rings so that two consumers never write the same cache line
+    cursorStride = nbThreads + 8;
+    cursors = new std::atomic<uint64_t>[nbThreads * cursorStride];
+    for(int i=0;i<nbThreads * cursorStride;i++) cursors[i] = 0;
+    nextRing.clear();
+    nextRing.growTo(nbThreads * 16, 0);
 }
 
 
-
 // Return true if the clause was succesfully added
 bool ClausesBuffer::pushClause(int threadId, Clause & c) {
-    if (!whenFullRemoveOlder && (queuesize + c.size() + headerSize >= maxsize))
-	return false; // We need to remove some old clauses
-    while (queuesize + c.size() + headerSize >= maxsize) { // We need to remove some old clauses
-	forcedRemovedClauses ++;
-	removeLastClause();
-	assert(queuesize > 0);
+    assert(threadId >= 0 && threadId < nbThreads);
+    if (c.size() > maxClauseSize())
+	return false;
+
+    ClauseRing & ring = rings[threadId];
+    uint64_t len = c.size() + 1;
+    uint64_t h = ring.head.load(std::memory_order_relaxed); // We are the only writer
+
+    if (!whenFullRemoveOlder) {
+	// Do not overwrite clauses that some thread did not read yet
+	for(int i=0;i<nbThreads;i++) {
+	    if (i != threadId && h + len - cursors[i * cursorStride + threadId].load(std::memory_order_acquire) > ringSize)
+		return false;
+	}
     }
-    noCheckPush(c.size());
-    noCheckPush(nbThreads>1?nbThreads-1:1);
-    noCheckPush(threadId);
+
+    ring.reserved.store(h + len, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    ring.elems[h & mask].store(c.size(), std::memory_order_relaxed);
     for(int i=0;i<c.size();i++)
-	noCheckPush(toInt(c[i]));
-    queuesize += c.size()+headerSize;
+	ring.elems[(h + 1 + i) & mask].store(toInt(c[i]), std::memory_order_relaxed);
+    ring.head.store(h + len, std::memory_order_release);
     return true;
-    //  printf(" -> (%d, %d)\n", first, last);
 }
 
-bool ClausesBuffer::getClause(int threadId, int & threadOrigin, vec<Lit> & resultClause,  bool firstFound) {
-    assert(lastOfThread.size() > threadId);
-    unsigned int thislast = lastOfThread[threadId];
-    assert(!firstFound || thislast == last); // FIXME: Gilles has this assertion on his cluster
-
-    // Early exiting
-    if (nextIndex(thislast) == first) return false;
+bool ClausesBuffer::readRing(int r, int consumer, vec<Lit> & resultClause, uint64_t & dropped) {
+    ClauseRing & ring = rings[r];
+    std::atomic<uint64_t> & cursor = cursors[consumer * cursorStride + r];
+    uint64_t pos = cursor.load(std::memory_order_relaxed); // We are the only writer
+
+    for(;;) {
+	uint64_t h = ring.head.load(std::memory_order_acquire);
+	if (pos == h) return false;
+	if (h - pos > ringSize) { // Lapped by the producer: the clauses until 'h' are lost
+	    dropped++;
+	    pos = h;
+	    cursor.store(pos, std::memory_order_release);
+	    continue;
+	}
 
-    if ( ( thislast < last && last < first) ||
-	    ( first < thislast && thislast < last ) ||
-	    ( last < first && first < thislast) ) {
-	// Special case where last has moved and lastOfThread[threadId] is no more valid (is behind)
-	thislast = last; 
-    }
-    assert(!firstFound);
-    // Go to next clause for this thread id
-    if (!firstFound) { 
-	while (nextIndex(thislast) != first && elems[addIndex(thislast,3)] == ((unsigned int)threadId)) { // 3 = 2 + 1 
-	    thislast = addIndex(thislast, elems[nextIndex(thislast)] + headerSize); // 
-	    assert(thislast >= 0);
-	    assert(thislast < maxsize);
+	uint32_t csize = ring.elems[pos & mask].load(std::memory_order_relaxed);
+	bool valid = csize < h - pos;
+	if (valid) {
+	    resultClause.clear();
+	    for(uint32_t i=0;i<csize;i++)
+		resultClause.push(toLit(ring.elems[(pos + 1 + i) & mask].load(std::memory_order_relaxed)));
 	}
-	assert(nextIndex(thislast)==first || elems[addIndex(thislast,3)] != (unsigned int)threadId);
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if (!valid || ring.reserved.load(std::memory_order_relaxed) - pos > ringSize) {
+	    // Overwritten while we were reading it
+	    dropped++;
+	    pos = ring.head.load(std::memory_order_acquire);
+	    cursor.store(pos, std::memory_order_release);
+	    continue;
+	}
+	cursor.store(pos + csize + 1, std::memory_order_release);
+	return true;
     }
+}
 
-    if (nextIndex(thislast) == first) {
-	lastOfThread[threadId] = thislast;
-	return false;
-    }  
-    assert(elems[addIndex(thislast,3)] != ((unsigned int) threadId));
-    unsigned int previouslast = thislast;
-    bool removeAfter = false;
-    int csize = noCheckPop(thislast);
-    removeAfter = (--elems[addIndex(thislast,1)] == 0); // We are sure this is not one of our own clause
-    thislast = nextIndex(thislast); // Skips the removeAfter fieldr
-    threadOrigin = noCheckPop(thislast);
-    assert(threadOrigin != threadId);
-    resultClause.clear();
-    for(int i=0;i<csize;i++) {
-	resultClause.push(toLit(noCheckPop(thislast)));
-    }
-    if (last == previouslast && removeAfter) {
-	removeLastClause();
-	thislast = last;
+bool ClausesBuffer::getClause(int threadId, int & threadOrigin, vec<Lit> & resultClause, uint64_t & dropped) {
+    assert(threadId >= 0 && threadId < nbThreads);
+    // Starts where the last clause was found, so that all the rings are read in turn
+    int & first = nextRing[threadId * 16];
+    for(int k=0;k<nbThreads;k++) {
+	int r = (first + k) % nbThreads;
+	if (r == threadId) continue;
+	if (readRing(r, threadId, resultClause, dropped)) {
+	    first = r;
+	    threadOrigin = r;
+	    return true;
+	}
     }
-    lastOfThread[threadId] = thislast;
-    return true;
+    return false;
 }
 
 
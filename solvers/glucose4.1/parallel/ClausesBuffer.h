@@ -50,6 +50,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #ifndef ClausesBuffer_h 
 #define ClausesBuffer_h
 
+#include <atomic>
 #include "mtl/Vec.h"
 #include "core/SolverTypes.h"
 #include "core/Solver.h"
@@ -57,54 +58,53 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 //=================================================================================================
 
 namespace Glucose {
+    // One ring per thread: only its thread writes clauses in it (single producer)
+    // and all the other threads read them with their own cursor (multiple consumers),
+    // so that no lock is needed.
     // index : size clause
-    // index + 1 : nbSeen
-    // index + 2 : threadId
-    // index + 3 : .. index + 3 + size : Lit of clause
+    // index + 1 .. index + size : Lit of clause
+    // Positions only grow, a position p is stored at p & mask.
+    // 'reserved' is moved past a clause before it is written and 'head' after, so a consumer
+    // knows that the clause it just read was overwritten when 'reserved' is more than a ring
+    // ahead of it.
+    struct ClauseRing {
+        std::atomic<uint64_t>  reserved;
+        std::atomic<uint64_t>  head;
+        std::atomic<uint32_t>* elems;
+        char                   padding[64]; // Keeps the positions of two rings in different cache lines
+    };
+
     class ClausesBuffer {
-	vec<uint32_t>  elems;
-	unsigned int     first;
-	unsigned int	 last;
-	unsigned int     maxsize;
-	unsigned int     queuesize; // Number of current elements (must be < maxsize !)
-	unsigned int     removedClauses;
-	unsigned int     forcedRemovedClauses;
-        static const int  headerSize = 3;
-	int       nbThreads;
-	bool      whenFullRemoveOlder;
-	unsigned int fifoSizeByCore;
-	vec<unsigned int> lastOfThread; // Last value for a thread 
+	ClauseRing*   rings;
+	// cursors[consumer * cursorStride + ring]: next position to read by the consumer in the
+	// ring. Each consumer only writes its own row of the array.
+	std::atomic<uint64_t>* cursors;
+	int           cursorStride;
+	uint64_t      ringSize;  // Power of two
+	uint64_t      mask;
+	int           nbThreads;
+	bool          whenFullRemoveOlder;
+	unsigned int  fifoSizeByCore;
+	vec<int>      nextRing;  // Ring where each consumer looks first (one cache line per consumer)
+
+	void release();
+	bool readRing(int ring, int consumer, vec<Lit> & resultClause, uint64_t & dropped);
 
 	public:
 	ClausesBuffer(int _nbThreads, unsigned int _maxsize);
 	ClausesBuffer();
+	~ClausesBuffer();
 
 	void setNbThreads(int _nbThreads);
-	unsigned int nextIndex(unsigned int i);
-	unsigned int addIndex(unsigned int i, unsigned int a); 
-	void removeLastClause(); 
-	   
-	void noCheckPush(uint32_t x);
-	uint32_t noCheckPop(unsigned int & index);
-
-	// Return true if the clause was succesfully added
+
+	// Return true if the clause was succesfully added, false if it does not fit in the ring
+	// or if the ring is full and the older clauses cannot be removed
         bool pushClause(int threadId, Clause & c);
-        bool getClause(int threadId, int & threadOrigin, vec<Lit> & resultClause, bool firstFound = false); 
+	// 'dropped' counts the clauses of other threads that were overwritten before being read
+        bool getClause(int threadId, int & threadOrigin, vec<Lit> & resultClause, uint64_t & dropped);
 	
-	int maxSize() const {return maxsize;}
-        uint32_t getCap();
-	void growTo(int size) {
-	    assert(0); // Not implemented (essentially for efficiency reasons)
-	    elems.growTo(size); 
-	    first=0; maxsize=size; queuesize = 0;last = 0;
-	    for(int i=0;i<size;i++) elems[i]=0; 
-	}
-
-	void fastclear() {first = 0; last = 0; queuesize=0; } 
-
-	int  size(void)    { return queuesize; }
-
-	void clear(bool dealloc = false)   { elems.clear(dealloc); first = 0; maxsize=0; queuesize=0;}
+	int maxSize() const {return (int)(ringSize*nbThreads);}
+	int maxClauseSize() const {return (int)(ringSize/2) - 1;}
 	inline  int  toInt     (Lit p)              { return p.x; } 
 
     };
@@ -65,11 +65,16 @@ static IntOption opt_nbsolversmultithreads(_parallel, "nthreads", "Number of cor
 static IntOption opt_maxnbsolvers(_parallel, "maxnbthreads", "Maximum number of core threads to ask for (when nbthreads=0)", 4);
 static IntOption opt_maxmemory(_parallel, "maxmemory", "Maximum memory to use (in Mb, 0 for no software limit)", 20000);
 static IntOption opt_statsInterval(_parallel, "statsinterval", "Seconds (real time) between two stats reports", 5);
+static BoolOption opt_shareClauses(_parallel, "shareclauses", "Keep one read-only copy of the original clauses for all the threads (needs ARENA=mmap)", false);
 //
 // Shared with ClausesBuffer.cc
 BoolOption opt_whenFullRemoveOlder(_parallel, "removeolder", "When the FIFO for exchanging clauses between threads is full, remove older clauses", false);
 IntOption opt_fifoSizeByCore(_parallel, "fifosize", "Size of the FIFO structure for exchanging clauses between threads, by threads", 100000);
 //
+// Shared with SharedCompanion.cc
+IntOption opt_maxSharedLBD(_parallel, "sharelbd", "Do not publish clauses with a larger LBD (0 for no limit)", 0, IntRange(0, INT32_MAX));
+IntOption opt_maxSharedSize(_parallel, "sharesize", "Do not publish clauses with a larger size (0 for no limit)", 0, IntRange(0, INT32_MAX));
+//
 // Shared options with Solver.cc 
 BoolOption opt_dontExportDirectReusedClauses(_cunstable, "reusedClauses", "Don't export directly reused clauses", false);
 BoolOption opt_plingeling(_cunstable, "plingeling", "plingeling strategy for sharing clauses (exploratory feature)", false);
@@ -137,6 +142,10 @@ void MultiSolvers::generateAllSolvers() {
     assert(solvers[0] != NULL);
     assert(allClonesAreBuilt == 0);
 
+    // The clones map the original clauses of the first solver instead of copying them
+    if(opt_shareClauses && !((SimpSolver *) solvers[0])->use_simplification && !solvers[0]->shareClauses())
+        printf("c Original clauses cannot be shared (build with ARENA=mmap), each thread copies them\n");
+
     for(int i = 1; i < nbsolvers; i++) {
         ParallelSolver *s = (ParallelSolver *) solvers[0]->clone();
         solvers.push(s);
@@ -280,14 +289,22 @@ void MultiSolvers::printStats() {
     }
     long long int totalconf = 0;
     long long int totalprop = 0;
+    uint64_t totalexported = 0;
+    uint64_t totalimported = 0;
+    uint64_t totalwait = 0;
     for(int i = 0; i < solvers.size(); i++) {
         totalconf += (long int) solvers[i]->conflicts;
         totalprop += solvers[i]->propagations;
+        totalexported += solvers[i]->stats[nbexported];
+        totalimported += solvers[i]->stats[nbimported];
+        totalwait += solvers[i]->stats[waitTimeMicros];
     }
     printf("c \n");
 
     printf("c synthesis %11lld conflicts %11lld propagations %8.0f conflicts/sec %8.0f propagations/sec\n",
            totalconf, totalprop, (double) totalconf / cpu_time, (double) totalprop / cpu_time);
+    printf("c sharing %8.0f exported/sec %8.0f imported/sec %8.3f s waiting for locks\n",
+           (double) totalexported / cpu_time, (double) totalimported / cpu_time, (double) totalwait / 1e6);
 
 
     nbprinted++;
@@ -456,6 +473,46 @@ void MultiSolvers::printFinalStats() {
         printf("| %10" PRIu64" ", solvers[i]->nbNotExportedBecauseDirectlyReused);
     printf("|\n");
 //--
+
+    printf("c | Filtered      ");
+    uint64_t filtered = 0;
+    for(int i = 0; i < solvers.size(); i++)
+        filtered += solvers[i]->stats[nbexportFiltered];
+    printf("| %15" PRIu64" ", filtered);
+    for(int i = 0; i < solvers.size(); i++)
+        printf("| %10" PRIu64" ", solvers[i]->stats[nbexportFiltered]);
+    printf("|\n");
+//--
+
+    printf("c | Ring_Full     ");
+    uint64_t rejected = 0;
+    for(int i = 0; i < solvers.size(); i++)
+        rejected += solvers[i]->stats[nbexportRejected];
+    printf("| %15" PRIu64" ", rejected);
+    for(int i = 0; i < solvers.size(); i++)
+        printf("| %10" PRIu64" ", solvers[i]->stats[nbexportRejected]);
+    printf("|\n");
+//--
+
+    printf("c | Dropped       ");
+    uint64_t dropped = 0;
+    for(int i = 0; i < solvers.size(); i++)
+        dropped += solvers[i]->stats[nbimportDropped];
+    printf("| %15" PRIu64" ", dropped);
+    for(int i = 0; i < solvers.size(); i++)
+        printf("| %10" PRIu64" ", solvers[i]->stats[nbimportDropped]);
+    printf("|\n");
+//--
+
+    printf("c | Wait_ms       ");
+    uint64_t waited = 0;
+    for(int i = 0; i < solvers.size(); i++)
+        waited += solvers[i]->stats[waitTimeMicros];
+    printf("| %15" PRIu64" ", waited / 1000);
+    for(int i = 0; i < solvers.size(); i++)
+        printf("| %10" PRIu64" ", solvers[i]->stats[waitTimeMicros] / 1000);
+    printf("|\n");
+//--
     printf("c |---------------|-----------------");
     for(int i = 0; i < solvers.size(); i++)
         printf("|------------");
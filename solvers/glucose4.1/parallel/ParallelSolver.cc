@@ -469,6 +469,10 @@ lbool ParallelSolver::solve_(bool do_simp, bool turn_off_simp) {
     while (status == l_Undef && !sharedcomp->jobFinished()) {
         status = search(luby_restart?luby(restart_inc, curr_restarts)*luby_restart_factor:0);  // the parameter is useless in glucose, kept to allow modifications
         if (!withinBudget()) break;
+        if (status == l_Undef && vivifyPending && decisionLevel() == 0) {
+            vivifyLearnts();
+            if (!ok) status = l_False;
+        }
         curr_restarts++;
     }
 
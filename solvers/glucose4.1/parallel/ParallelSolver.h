@@ -62,9 +62,13 @@ namespace Glucose {
        nbexportedunit,
        nbimportedunit,
        nbimportedInPurgatory,
-       nbImportedGoodClauses
+       nbImportedGoodClauses,
+       nbexportFiltered,   // not published, LBD or size too large
+       nbexportRejected,   // not published, ring full
+       nbimportDropped,    // overwritten before they were read
+       waitTimeMicros      // time spent waiting for the shared companion locks
    } ;
-#define parallelStatsSize (coreStatsSize + 6)
+#define parallelStatsSize (coreStatsSize + 10)
  
 //=================================================================================================
     //class MultiSolvers;
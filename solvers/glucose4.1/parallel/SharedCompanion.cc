@@ -52,25 +52,31 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "core/SolverTypes.h"
 #include "parallel/ClausesBuffer.h"
 #include "parallel/SharedCompanion.h"
+#include "utils/System.h"
 
 
 using namespace Glucose;
 
+extern IntOption opt_maxSharedLBD;
+extern IntOption opt_maxSharedSize;
+
 SharedCompanion::SharedCompanion(int _nbThreads) :
     nbThreads(_nbThreads), 
+    maxSharedLBD(opt_maxSharedLBD),
+    maxSharedSize(opt_maxSharedSize),
     bjobFinished(false),
     jobFinishedBy(NULL),
     panicMode(false), // The bug in the SAT2014 competition :)
     jobStatus(l_Undef),
     random_seed(9164825) {
+	nbUnits = 0;
 
-	pthread_mutex_init(&mutexSharedClauseCompanion,NULL); // This is the shared companion lock
 	pthread_mutex_init(&mutexSharedUnitCompanion,NULL); // This is the shared companion lock
 	pthread_mutex_init(&mutexSharedCompanion,NULL); // This is the shared companion lock
 	pthread_mutex_init(&mutexJobFinished,NULL); // This is the shared companion lock
 	if (_nbThreads> 0)  {
 	    setNbThreads(_nbThreads);
-	    fprintf(stdout,"c Shared companion initialized: handling of clauses of %d threads.\nc %d ints for the sharing clause buffer (not expandable) .\n", _nbThreads, clausesBuffer.maxSize());
+	    fprintf(stdout,"c Shared companion initialized: handling of clauses of %d threads.\nc %d ints for the sharing clause rings (not expandable) .\n", _nbThreads, clausesBuffer.maxSize());
 	}
 
 }
@@ -97,10 +103,18 @@ void SharedCompanion::newVar(bool sign) {
    isUnary .push(l_Undef);
 }
 
+void SharedCompanion::lock(ParallelSolver *s, pthread_mutex_t *mutex) {
+  if (pthread_mutex_trylock(mutex) == 0) return;
+  double start = realTime();
+  pthread_mutex_lock(mutex);
+  s->stats[waitTimeMicros] += (uint64_t)((realTime() - start) * 1e6);
+}
+
 void SharedCompanion::addLearnt(ParallelSolver *s,Lit unary) {
-  pthread_mutex_lock(&mutexSharedUnitCompanion);
+  lock(s, &mutexSharedUnitCompanion);
   if (isUnary[var(unary)]==l_Undef) {
       unitLit.push(unary);
+      nbUnits.store(unitLit.size(), std::memory_order_release);
       isUnary[var(unary)] = sign(unary)?l_False:l_True;
   } 
   pthread_mutex_unlock(&mutexSharedUnitCompanion);
@@ -110,7 +124,10 @@ Lit SharedCompanion::getUnary(ParallelSolver *s) {
   int sn = s->thn;
   Lit ret = lit_Undef;
 
-  pthread_mutex_lock(&mutexSharedUnitCompanion);
+  // Only take the lock if there is something new for us (unitLit only grows)
+  if (nextUnit[sn] >= nbUnits.load(std::memory_order_acquire))
+      return ret;
+  lock(s, &mutexSharedUnitCompanion);
   if (nextUnit[sn] < unitLit.size())
       ret = unitLit[nextUnit[sn]++];
   pthread_mutex_unlock(&mutexSharedUnitCompanion);
@@ -118,29 +135,27 @@ Lit SharedCompanion::getUnary(ParallelSolver *s) {
 }
 
 // Specialized functions for this companion
-// must be multithread safe
+// must be multithread safe (each thread only writes its own ring, no lock is taken)
 // Add a clause to the threads-wide clause database (all clauses, through)
 bool SharedCompanion::addLearnt(ParallelSolver *s, Clause & c) { 
   int sn = s->thn; // thread number of the solver
-  bool ret = false;
   assert(watchedSolvers.size()>sn);
 
-  pthread_mutex_lock(&mutexSharedClauseCompanion);
-  ret = clausesBuffer.pushClause(sn, c);
-  pthread_mutex_unlock(&mutexSharedClauseCompanion);
+  // Filter before touching the shared memory
+  if ((maxSharedLBD > 0 && c.lbd() > maxSharedLBD) || (maxSharedSize > 0 && c.size() > maxSharedSize)) {
+      s->stats[nbexportFiltered]++;
+      return false;
+  }
+  bool ret = clausesBuffer.pushClause(sn, c);
+  if (!ret)
+      s->stats[nbexportRejected]++;
   return ret;
 }
 
 
 bool SharedCompanion::getNewClause(ParallelSolver *s, int & threadOrigin, vec<Lit>& newclause) { // gets a new interesting clause for solver s 
   int sn = s->thn;
-  
-    // First, let's get the clauses on the big blackboard
-    pthread_mutex_lock(&mutexSharedClauseCompanion);
-    bool b = clausesBuffer.getClause(sn, threadOrigin, newclause);
-    pthread_mutex_unlock(&mutexSharedClauseCompanion);
- 
-  return b;
+  return clausesBuffer.getClause(sn, threadOrigin, newclause, s->stats[nbimportDropped]);
 }
 
 bool SharedCompanion::jobFinished() {
@@ -56,6 +56,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 #ifndef SharedCompanion_h
 #define SharedCompanion_h
+#include <atomic>
 #include "core/SolverTypes.h"
 #include "parallel/ParallelSolver.h"
 #include "parallel/SolverCompanion.h"
@@ -85,12 +86,15 @@ public:
 
  protected:
 
-	ClausesBuffer clausesBuffer; // A big blackboard for all threads sharing non unary clauses
+	ClausesBuffer clausesBuffer; // One lock-free ring by thread for sharing non unary clauses
 	int nbThreads;               // Number of threads
+	unsigned int maxSharedLBD;   // Clauses with a larger LBD (or size) are not published (0 = no limit)
+	int maxSharedSize;
+
+	void lock(ParallelSolver *s, pthread_mutex_t *mutex); // Locks 'mutex' and accounts the time waited by s
 	
 	// A set of mutex variables
 	pthread_mutex_t mutexSharedCompanion; // mutex for any high level sync between all threads (like reportf)
-	pthread_mutex_t mutexSharedClauseCompanion; // mutex for reading/writing clauses on the blackboard
 	pthread_mutex_t mutexSharedUnitCompanion; // mutex for reading/writing unit clauses on the blackboard 
         pthread_mutex_t mutexJobFinished;
 
@@ -103,6 +107,7 @@ public:
 	//	friend class wholearnt;
 	vec<int> nextUnit; // indice of next unit clause to retrieve for solver number i 
 	vec<Lit> unitLit;  // Set of unit literals found so far
+	std::atomic<int> nbUnits; // Size of unitLit, read without the lock
         vec<lbool> isUnary; // sign of the unary var (if proved, or l_Undef if not)	
 	double    random_seed;
 
@@ -62,6 +62,7 @@ static const char* _cat = "SIMP";
 static BoolOption   opt_use_asymm        (_cat, "asymm",        "Shrink clauses by asymmetric branching.", false);
 static BoolOption   opt_use_rcheck       (_cat, "rcheck",       "Check if a clause is already implied. (costly)", false);
 static BoolOption   opt_use_elim         (_cat, "elim",         "Perform variable elimination.", true);
+static BoolOption   opt_use_eqsub        (_cat, "eqsub",        "Substitute equivalent literals (cycles of binary clauses).", true);
 static IntOption    opt_grow             (_cat, "grow",         "Allow a variable elimination step to grow by a number of clauses.", 0);
 static IntOption    opt_clause_lim       (_cat, "cl-lim",       "Variables are not eliminated if it produces a resolvent with a length above this limit. -1 means no limit", 20,   IntRange(-1, INT32_MAX));
 static IntOption    opt_subsumption_lim  (_cat, "sub-lim",      "Do not check if subsumption against a clause larger than this. -1 means no limit.", 1000, IntRange(-1, INT32_MAX));
@@ -81,9 +82,11 @@ SimpSolver::SimpSolver() :
   , use_asymm          (opt_use_asymm)
   , use_rcheck         (opt_use_rcheck)
   , use_elim           (opt_use_elim)
+  , use_eqsub          (opt_use_eqsub)
   , merges             (0)
   , asymm_lits         (0)
   , eliminated_vars    (0)
+  , substituted_vars   (0)
   , use_simplification (true)
   , elimorder          (1)
   , occurs             (ClauseDeleted(ca))
@@ -112,9 +115,11 @@ SimpSolver::SimpSolver(const SimpSolver &s) : Solver(s)
   , use_asymm          (s.use_asymm)
   , use_rcheck         (s.use_rcheck)
   , use_elim           (s.use_elim)
+  , use_eqsub          (s.use_eqsub)
   , merges             (s.merges)
   , asymm_lits         (s.asymm_lits)
   , eliminated_vars    (s.eliminated_vars)
+  , substituted_vars   (s.substituted_vars)
   , use_simplification (s.use_simplification)
   , elimorder          (s.elimorder)
   , occurs             (ClauseDeleted(ca))
@@ -170,6 +175,8 @@ lbool SimpSolver::solve_(bool do_simp, bool turn_off_simp)
     do_simp &= use_simplification;
 
     if (do_simp){
+        cancelUntil(0);
+
         // Assumptions must be temporarily frozen to run variable elimination:
         for (int i = 0; i < assumptions.size(); i++){
             Var v = var(assumptions[i]);
@@ -205,6 +212,17 @@ lbool SimpSolver::solve_(bool do_simp, bool turn_off_simp)
 
 
 
+bool SimpSolver::addAtMostOne(const vec<Lit>& ps)
+{
+    // Elimination only sees clauses, the constraint must keep its variables:
+    for (int i = 0; i < ps.size(); i++){
+        assert(!isEliminated(var(ps[i])));
+        setFrozen(var(ps[i]), true); }
+
+    return Solver::addAtMostOne(ps);
+}
+
+
 bool SimpSolver::addClause_(vec<Lit>& ps)
 {
 #ifndef NDEBUG
@@ -213,6 +231,10 @@ bool SimpSolver::addClause_(vec<Lit>& ps)
 #endif
     int nclauses = clauses.size();
 
+    // Occurrence lists and elimination only deal with the root level
+    if (use_simplification || use_rcheck)
+        cancelUntil(0);
+
     if (use_rcheck && implied(ps))
         return true;
 
@@ -557,6 +579,14 @@ static void mkElimClause(vec<uint32_t>& elimclauses, Lit x)
 }
 
 
+static void mkElimClause(vec<uint32_t>& elimclauses, Lit x, Lit y)
+{
+    elimclauses.push(toInt(x));
+    elimclauses.push(toInt(y));
+    elimclauses.push(2);
+}
+
+
 static void mkElimClause(vec<uint32_t>& elimclauses, Var v, Clause& c)
 {
     int first = elimclauses.size();
@@ -640,6 +670,8 @@ bool SimpSolver::eliminateVar(Var v)
     // Free watchers lists for this variable, if possible:
     if (watches[ mkLit(v)].size() == 0) watches[ mkLit(v)].clear(true);
     if (watches[~mkLit(v)].size() == 0) watches[~mkLit(v)].clear(true);
+    if (watchesTern[ mkLit(v)].size() == 0) watchesTern[ mkLit(v)].clear(true);
+    if (watchesTern[~mkLit(v)].size() == 0) watchesTern[~mkLit(v)].clear(true);
 
     return backwardSubsumptionCheck();
 }
@@ -679,6 +711,107 @@ bool SimpSolver::substitute(Var v, Lit x)
 }
 
 
+// Finds the strongly connected components of the binary implication graph; the literals of a
+// component are equivalent. Every variable of a component is substituted by the representative of
+// its component, a frozen variable if there is one. Returns FALSE if some p and ~p are equivalent.
+//
+bool SimpSolver::substituteEquivalences()
+{
+    int nLits = 2 * nVars();
+
+    // Implication graph of the binary clauses in compressed form:
+    vec<int> start(nLits + 1, 0);
+    vec<int> edges;
+    for (int pass = 0; pass < 2; pass++){
+        vec<int> fill;
+        if (pass == 1){
+            for (int i = 0; i < nLits; i++) start[i + 1] += start[i];
+            start.copyTo(fill);
+            edges.growTo(start[nLits]); }
+        for (int i = 0; i < clauses.size(); i++){
+            const Clause& c = ca[clauses[i]];
+            if (c.mark() || c.size() != 2 || value(c[0]) != l_Undef || value(c[1]) != l_Undef)
+                continue;
+            if (pass == 0){
+                start[toInt(~c[0]) + 1]++;
+                start[toInt(~c[1]) + 1]++;
+            }else{
+                edges[fill[toInt(~c[0])]++] = toInt(c[1]);
+                edges[fill[toInt(~c[1])]++] = toInt(c[0]); }
+        }
+    }
+    if (edges.size() == 0)
+        return true;
+
+    // Iterative Tarjan:
+    vec<int>  index(nLits, -1), low(nLits, 0), comp(nLits, -1);
+    vec<char> on_stack(nLits, 0);
+    vec<int>  stack, call_node, call_edge;
+    int       counter = 0, n_comps = 0;
+    for (int root = 0; root < nLits; root++){
+        if (index[root] != -1 || start[root] == start[root + 1]) continue;
+        call_node.push(root); call_edge.push(start[root]);
+        index[root] = low[root] = counter++;
+        stack.push(root); on_stack[root] = 1;
+        while (call_node.size() > 0){
+            int u = call_node.last();
+            int& e = call_edge.last();
+            if (e < start[u + 1]){
+                int w = edges[e++];
+                if (index[w] == -1){
+                    index[w] = low[w] = counter++;
+                    stack.push(w); on_stack[w] = 1;
+                    call_node.push(w); call_edge.push(start[w]);
+                }else if (on_stack[w] && index[w] < low[u])
+                    low[u] = index[w];
+                continue; }
+            call_node.pop(); call_edge.pop();
+            if (call_node.size() > 0 && low[u] < low[call_node.last()])
+                low[call_node.last()] = low[u];
+            if (low[u] == index[u]){
+                int w;
+                do{
+                    w = stack.last(); stack.pop();
+                    on_stack[w] = 0;
+                    comp[w] = n_comps;
+                }while (w != u);
+                n_comps++; }
+        }
+    }
+
+    // Representatives: frozen variables first, then the smallest variable. The choice only
+    // depends on the variable, so the complement component gets the complement literal.
+    vec<Lit> rep(n_comps, lit_Undef);
+    for (int i = 0; i < nLits; i++){
+        if (comp[i] == -1) continue;
+        Lit p = toLit(i);
+        Lit r = rep[comp[i]];
+        if (r == lit_Undef || (frozen[var(p)] && !frozen[var(r)]) || (frozen[var(p)] == frozen[var(r)] && var(p) < var(r)))
+            rep[comp[i]] = p;
+    }
+
+    for (Var v = 0; v < nVars(); v++){
+        Lit p = mkLit(v);
+        if (comp[toInt(p)] == -1) continue;
+        if (comp[toInt(p)] == comp[toInt(~p)])
+            return ok = false;
+        Lit r = rep[comp[toInt(p)]];
+        if (var(r) == v || frozen[v] || isEliminated(v) || isEliminated(var(r)) || value(v) != l_Undef || value(r) != l_Undef)
+            continue;
+
+        // v takes the value of r when the model is extended:
+        mkElimClause(elimclauses, p, ~r);
+        mkElimClause(elimclauses, ~p, r);
+        mkElimClause(elimclauses, ~p);
+        if (!substitute(v, r))
+            return false;
+        substituted_vars++;
+    }
+
+    return true;
+}
+
+
 void SimpSolver::extendModel()
 {
     int i, j;
@@ -716,6 +849,9 @@ bool SimpSolver::eliminate(bool turn_off_elim)
       printf("c Too many clauses... No preprocessing\n");
     }
 
+    if (toPerform && use_eqsub && !substituteEquivalences()){
+        ok = false; goto cleanup; }
+
     while (toPerform && (n_touched > 0 || bwdsub_assigns < trail.size() || elim_heap.size() > 0)){
 
         gatherTouchedClauses();
@@ -841,10 +977,12 @@ void SimpSolver::garbageCollect()
 
     cleanUpClauses();
     to.extra_clause_field = ca.extra_clause_field; // NOTE: this is important to keep (or lose) the extra fields.
+    ca.shareTo(to);
     relocAll(to);
     Solver::relocAll(to);
     if (verbosity >= 2)
         printf("|  Garbage collection:   %12d bytes => %12d bytes             |\n", 
                ca.size()*ClauseAllocator::Unit_Size, to.size()*ClauseAllocator::Unit_Size);
     to.moveTo(ca);
+    compactWatches();
 }
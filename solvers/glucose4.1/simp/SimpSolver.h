@@ -86,6 +86,7 @@ class SimpSolver : public Solver {
     bool    addClause (Lit p, Lit q);        // Add a binary clause to the solver.
     bool    addClause (Lit p, Lit q, Lit r); // Add a ternary clause to the solver.
     virtual bool    addClause_(      vec<Lit>& ps);
+    virtual bool    addAtMostOne(const vec<Lit>& ps); // The variables of native constraints are frozen.
     bool    substitute(Var v, Lit x);  // Replace all occurences of v with x (may cause a contradiction).
 
     // Variable mode:
@@ -130,11 +131,13 @@ class SimpSolver : public Solver {
     bool    use_asymm;         // Shrink clauses by asymmetric branching.
     bool    use_rcheck;        // Check if a clause is already implied. Prett costly, and subsumes subsumptions :)
     bool    use_elim;          // Perform variable elimination.
+    bool    use_eqsub;         // Substitute equivalent literals before variable elimination.
     // Statistics:
     //
     int     merges;
     int     asymm_lits;
     int     eliminated_vars;
+    int     substituted_vars;
     bool                use_simplification;
 
  protected:
@@ -192,6 +195,7 @@ class SimpSolver : public Solver {
     bool          merge                    (const Clause& _ps, const Clause& _qs, Var v, int& size);
     bool          backwardSubsumptionCheck (bool verbose = false);
     bool          eliminateVar             (Var v);
+    bool          substituteEquivalences   ();
     void          extendModel              ();
 
     void          removeClause             (CRef cr,bool inPurgatory=false);
@@ -0,0 +1,51 @@
+#!/bin/bash
+# bench-encodings.sh
+#
+# compare formula size and solving time of the MAPF and at-most-one encodings
+#
+# usage: tools/bench-encodings.sh [mtms options] <instance> [<instance> ...]
+# the options are passed to every run, ENCODINGS selects the MAPF encodings
+# (default "0 1 2 3") and AMO_ENCODINGS the at-most-one encodings (default 4)
+
+ENCODINGS=${ENCODINGS:-"0 1 2 3"}
+AMO_ENCODINGS=${AMO_ENCODINGS:-"4"}
+SOLVER=${SOLVER:-./mtms}
+
+if [ ! -x "$SOLVER" ]
+then
+	echo "Error: $SOLVER not found, build it first or set SOLVER, abort!"
+	exit 1
+fi
+
+OPTIONS=()
+while [ $# -gt 0 ] && [ "${1:0:1}" = "-" ]
+do
+	OPTIONS+=("$1")
+	shift
+done
+
+# make sure we clean up
+trap 'rm -rf $TMPD' EXIT
+TMPD=$(mktemp -d)
+
+printf "%-30s %4s %4s %6s %12s %12s %10s %10s\n" instance enc amo bound vars clauses cost time[s]
+for instance in "$@"
+do
+	for encoding in $ENCODINGS
+	do
+	for amo in $AMO_ENCODINGS
+	do
+		LOG="$TMPD"/run.log
+		START=$(date +%s.%N)
+		"$SOLVER" "${OPTIONS[@]}" -encoding=$encoding -amoEncoding=$amo "$instance" "$TMPD"/out > "$LOG"
+		END=$(date +%s.%N)
+		# size of the last (largest) formula that was solved
+		BOUND=$(grep "Encoded with bound" "$LOG" | tail -n 1 | awk '{print $NF}')
+		VARS=$(grep "Number of variables" "$LOG" | tail -n 1 | awk '{print $NF}')
+		CLAUSES=$(grep "Number of hard clauses" "$LOG" | tail -n 1 | awk '{print $NF}')
+		COST=$(grep "^s Solution with cost" "$LOG" | tail -n 1 | awk '{print $5}')
+		TIME=$(awk "BEGIN {printf \"%.2f\", $END - $START}")
+		printf "%-30s %4s %4s %6s %12s %12s %10s %10s\n" "$(basename "$instance")" "$encoding" "$amo" "$BOUND" "$VARS" "$CLAUSES" "${COST:--}" "$TIME"
+	done
+	done
+done
@@ -0,0 +1,54 @@
+#!/bin/bash
+# bench-propagation.sh
+#
+# compare the propagation speed of the Glucose variants on CNF formulas
+#
+# usage: tools/bench-propagation.sh [glucose options] <cnf> [<cnf> ...]
+# the options are passed to every run, VARIANTS lists the option sets that are
+# compared, separated by ':', an empty set stands for the default options
+# (default: without prefetching, with ternary watchers, then the default).
+# SOLVER is the standalone Glucose, build it with "make -C solvers/glucose4.1/simp r"
+
+VARIANTS=${VARIANTS-"-no-prefetch:-ternary:"}
+SOLVER=${SOLVER:-solvers/glucose4.1/simp/glucose_release}
+
+if [ ! -x "$SOLVER" ]
+then
+	echo "Error: $SOLVER not found, build it first or set SOLVER, abort!"
+	exit 1
+fi
+
+OPTIONS=()
+while [ $# -gt 0 ] && [ "${1:0:1}" = "-" ]
+do
+	OPTIONS+=("$1")
+	shift
+done
+
+# make sure we clean up
+trap 'rm -rf $TMPD' EXIT
+TMPD=$(mktemp -d)
+
+IFS=':' read -r -a VARIANT_LIST <<< "$VARIANTS"
+# (read drops a trailing empty set)
+if [ -z "$VARIANTS" ] || [ "${VARIANTS: -1}" = ":" ]
+then
+	VARIANT_LIST+=("")
+fi
+
+printf "%-24s %-28s %6s %12s %14s %12s %10s\n" instance variant result conflicts propagations props/s time[s]
+for instance in "$@"
+do
+	for variant in "${VARIANT_LIST[@]}"
+	do
+		LOG="$TMPD"/run.log
+		# (the variant is split into its options on purpose)
+		"$SOLVER" "${OPTIONS[@]}" $variant "$instance" > "$LOG"
+		RESULT=$(grep "^s " "$LOG" | awk '{print $2}')
+		CONFLICTS=$(grep "^c conflicts" "$LOG" | awk '{print $4}')
+		PROPAGATIONS=$(grep "^c propagations" "$LOG" | awk '{print $4}')
+		TIME=$(grep "^c CPU time" "$LOG" | awk '{print $5}')
+		RATE=$(awk "BEGIN {if ($TIME > 0) printf \"%.0f\", $PROPAGATIONS / $TIME; else print \"-\"}")
+		printf "%-24s %-28s %6s %12s %14s %12s %10s\n" "$(basename "$instance")" "${variant:-default}" "${RESULT:--}" "$CONFLICTS" "$PROPAGATIONS" "$RATE" "$TIME"
+	done
+done